@@ -431,6 +431,8 @@ struct hash
     ULONG             secret_len;
     struct hash_impl  outer;
     struct hash_impl  inner;
+    struct hash_impl  outer_init; /* HMAC state after hashing the key, restored on reuse */
+    struct hash_impl  inner_init;
 };
 
 #define BLOCK_LENGTH_3DES       8
@@ -830,7 +832,24 @@ static NTSTATUS hash_prepare( struct hash *hash )
     for (i = 0; i < block_bytes; i++) buffer[i] ^= 0x5c;
     if ((status = hash_update( &hash->outer, hash->alg_id, buffer, block_bytes ))) return status;
     for (i = 0; i < block_bytes; i++) buffer[i] ^= (0x5c ^ 0x36);
-    return hash_update( &hash->inner, hash->alg_id, buffer, block_bytes );
+    if ((status = hash_update( &hash->inner, hash->alg_id, buffer, block_bytes ))) return status;
+
+    if (hash->flags & HASH_FLAG_REUSABLE)
+    {
+        hash->outer_init = hash->outer;
+        hash->inner_init = hash->inner;
+    }
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS hash_reset( struct hash *hash )
+{
+    if (!(hash->flags & HASH_FLAG_HMAC)) return hash_init( &hash->inner, hash->alg_id );
+
+    /* don't hash the key again, e.g. for every PBKDF2 iteration */
+    hash->outer = hash->outer_init;
+    hash->inner = hash->inner_init;
+    return STATUS_SUCCESS;
 }
 
 static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG secret_len, ULONG flags,
@@ -880,7 +899,11 @@ NTSTATUS WINAPI BCryptCreateHash( BCRYPT_ALG_HANDLE algorithm, BCRYPT_HASH_HANDL
     }
 
     if (!alg || alg->hdr.magic != MAGIC_ALG) return STATUS_INVALID_HANDLE;
-    if (object) FIXME( "ignoring object buffer\n" );
+    if (object)
+    {
+        static int once;
+        if (!once++) FIXME( "ignoring object buffer\n" );
+    }
 
     if ((status = hash_create( alg, secret, secret_len, flags, &hash ))) return status;
     *handle = hash;
@@ -953,7 +976,7 @@ static NTSTATUS hash_finalize( struct hash *hash, UCHAR *output, ULONG size )
     if (!(hash->flags & HASH_FLAG_HMAC))
     {
         if ((status = hash_finish( &hash->inner, hash->alg_id, output, size ))) return status;
-        if (hash->flags & HASH_FLAG_REUSABLE) return hash_prepare( hash );
+        if (hash->flags & HASH_FLAG_REUSABLE) return hash_reset( hash );
         return STATUS_SUCCESS;
     }
 
@@ -962,7 +985,7 @@ static NTSTATUS hash_finalize( struct hash *hash, UCHAR *output, ULONG size )
     if ((status = hash_update( &hash->outer, hash->alg_id, buffer, hash_length ))) return status;
     if ((status = hash_finish( &hash->outer, hash->alg_id, output, size ))) return status;
 
-    if (hash->flags & HASH_FLAG_REUSABLE) return hash_prepare( hash );
+    if (hash->flags & HASH_FLAG_REUSABLE) return hash_reset( hash );
     return STATUS_SUCCESS;
 }
 
@@ -982,22 +1005,23 @@ NTSTATUS WINAPI BCryptHash( BCRYPT_ALG_HANDLE algorithm, UCHAR *secret, ULONG se
                             UCHAR *input, ULONG input_len, UCHAR *output, ULONG output_len )
 {
     struct algorithm *alg = algorithm;
-    struct hash *hash;
+    struct hash hash;
     NTSTATUS status;
 
     TRACE( "%p, %p, %lu, %p, %lu, %p, %lu\n", algorithm, secret, secret_len, input, input_len, output, output_len );
 
     if (!alg || alg->hdr.magic != MAGIC_ALG) return STATUS_INVALID_HANDLE;
 
-    if ((status = hash_create( alg, secret, secret_len, 0, &hash ))) return status;
-    if ((status = hash_update( &hash->inner, hash->alg_id, input, input_len )))
-    {
-        hash_destroy( hash );
-        return status;
-    }
-    status = hash_finalize( hash, output, output_len );
-    hash_destroy( hash );
-    return status;
+    /* no handle escapes, so keep the state on the stack and don't copy the secret */
+    hash.hdr.magic  = MAGIC_HASH;
+    hash.alg_id     = alg->id;
+    hash.flags      = (alg->flags & BCRYPT_ALG_HANDLE_HMAC_FLAG) ? HASH_FLAG_HMAC : 0;
+    hash.secret     = secret;
+    hash.secret_len = secret_len;
+
+    if ((status = hash_prepare( &hash ))) return status;
+    if ((status = hash_update( &hash.inner, hash.alg_id, input, input_len ))) return status;
+    return hash_finalize( &hash, output, output_len );
 }
 
 static NTSTATUS key_asymmetric_alloc( struct key *key, ULONG bitlen )
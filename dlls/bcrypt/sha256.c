@@ -22,6 +22,11 @@
 
 #include "bcrypt_internal.h"
 
+#if (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || __GNUC__ >= 5)
+#define USE_SHA_NI
+#include <intrin.h>
+#endif
+
 static DWORD ror(DWORD n, int k) { return (n >> k) | (n << (32-k)); }
 #define Ch(x,y,z)  (z ^ (x & (y ^ z)))
 #define Maj(x,y,z) ((x & y) | (z & (x | y)))
@@ -91,6 +96,104 @@ static void processblock(SHA256_CTX *ctx, const UCHAR *buffer)
     ctx->h[7] += h;
 }
 
+#ifdef USE_SHA_NI
+
+static BOOL sha_ni_supported(void)
+{
+    static int supported = -1;
+    int regs[4];
+
+    if (supported == -1)
+    {
+        __cpuid(regs, 0);
+        if (regs[0] < 7) supported = 0;
+        else
+        {
+            /* SHA extensions, plus SSSE3 and SSE4.1 for the shuffles and blends */
+            __cpuid(regs, 1);
+            supported = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19));
+            __cpuidex(regs, 7, 0);
+            supported = supported && (regs[1] & (1 << 29));
+        }
+    }
+    return supported;
+}
+
+#define SHA_NI_ROUNDS(m, k) \
+    msg = _mm_add_epi32(m, _mm_loadu_si128((const __m128i *)(K + (k)))); \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e))
+
+#define SHA_NI_SCHEDULE(m0, m1, m2, m3) \
+    m0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), _mm_alignr_epi8(m3, m2, 4)), m3)
+
+static void __attribute__((target("sha,sse4.1"))) processblocks_sha_ni(SHA256_CTX *ctx, const UCHAR *buffer, ULONG count)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, abef, cdgh, msg, m0, m1, m2, m3, tmp;
+    int i;
+
+    /* the round instructions want the state as ABEF and CDGH */
+    tmp    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&ctx->h[0]), 0xb1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&ctx->h[4]), 0x1b);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; count; count--, buffer += 64)
+    {
+        abef = state0;
+        cdgh = state1;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)buffer), bswap);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 16)), bswap);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 32)), bswap);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 48)), bswap);
+
+        SHA_NI_ROUNDS(m0, 0);
+        SHA_NI_ROUNDS(m1, 4);
+        SHA_NI_ROUNDS(m2, 8);
+        SHA_NI_ROUNDS(m3, 12);
+
+        for (i = 16; i < 64; i += 16)
+        {
+            SHA_NI_SCHEDULE(m0, m1, m2, m3);
+            SHA_NI_ROUNDS(m0, i);
+            SHA_NI_SCHEDULE(m1, m2, m3, m0);
+            SHA_NI_ROUNDS(m1, i + 4);
+            SHA_NI_SCHEDULE(m2, m3, m0, m1);
+            SHA_NI_ROUNDS(m2, i + 8);
+            SHA_NI_SCHEDULE(m3, m0, m1, m2);
+            SHA_NI_ROUNDS(m3, i + 12);
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128((__m128i *)&ctx->h[0], _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128((__m128i *)&ctx->h[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#undef SHA_NI_ROUNDS
+#undef SHA_NI_SCHEDULE
+
+#endif /* USE_SHA_NI */
+
+static void processblocks(SHA256_CTX *ctx, const UCHAR *buffer, ULONG count)
+{
+#ifdef USE_SHA_NI
+    if (sha_ni_supported())
+    {
+        processblocks_sha_ni(ctx, buffer, count);
+        return;
+    }
+#endif
+    for (; count; count--, buffer += 64)
+        processblock(ctx, buffer);
+}
+
 static void pad(SHA256_CTX *ctx)
 {
     ULONG64 r = ctx->len % 64;
@@ -101,7 +204,7 @@ static void pad(SHA256_CTX *ctx)
     {
         memset(ctx->buf + r, 0, 64 - r);
         r = 0;
-        processblock(ctx, ctx->buf);
+        processblocks(ctx, ctx->buf, 1);
     }
 
     memset(ctx->buf + r, 0, 56 - r);
@@ -115,7 +218,7 @@ static void pad(SHA256_CTX *ctx)
     ctx->buf[62] = ctx->len >> 8;
     ctx->buf[63] = ctx->len;
 
-    processblock(ctx, ctx->buf);
+    processblocks(ctx, ctx->buf, 1);
 }
 
 void sha256_init(SHA256_CTX *ctx)
@@ -147,10 +250,11 @@ void sha256_update(SHA256_CTX *ctx, const UCHAR *buffer, ULONG len)
         memcpy(ctx->buf + r, p, 64 - r);
         len -= 64 - r;
         p += 64 - r;
-        processblock(ctx, ctx->buf);
+        processblocks(ctx, ctx->buf, 1);
     }
-    for (; len >= 64; len -= 64, p += 64)
-        processblock(ctx, p);
+    processblocks(ctx, p, len / 64);
+    p += len & ~63;
+    len &= 63;
     memcpy(ctx->buf, p, len);
 }
 
@@ -347,6 +347,25 @@ static int make_decode_table(cab_ULONG nsyms, cab_ULONG nbits,
   return 0;
 }
 
+/*************************************************************************
+ * fdi_copy_match (internal)
+ *
+ * Copies a match within the decompression window and returns the end of the
+ * destination.  When the source lies less than len bytes behind the
+ * destination, the copy has to repeat the bytes it has just written, so only
+ * that case is done a byte at a time.
+ */
+static inline cab_UBYTE *fdi_copy_match(cab_UBYTE *dest, const cab_UBYTE *src, int len)
+{
+  if (len <= 0) return dest;
+  if (src >= dest || dest - src >= len) {
+    memmove(dest, src, len);
+    return dest + len;
+  }
+  while (len--) *dest++ = *src++;
+  return dest;
+}
+
 /*************************************************************************
  * checksum (internal)
  */
@@ -1124,10 +1143,9 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
         e = ZIPWSIZE - max(d, w);
         e = min(e, n);
         n -= e;
-        do
-        {
-          CAB(outbuf)[w++] = CAB(outbuf)[d++];
-        } while (--e);
+        fdi_copy_match(CAB(outbuf) + w, CAB(outbuf) + d, e);
+        w += e;
+        d += e;
       } while (n);
     }
   }
@@ -1530,14 +1548,14 @@ static int QTMfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
         if (copy_length < match_length) {
           match_length -= copy_length;
           window_posn += copy_length;
-          while (copy_length-- > 0) *rundest++ = *runsrc++;
+          rundest = fdi_copy_match(rundest, runsrc, copy_length);
           runsrc = window;
         }
       }
       window_posn += match_length;
 
       /* copy match data - no worries about destination wraps */
-      while (match_length-- > 0) *rundest++ = *runsrc++;
+      fdi_copy_match(rundest, runsrc, match_length);
     }
   } /* while (togo > 0) */
 
@@ -1768,14 +1786,14 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                rundest = fdi_copy_match(rundest, runsrc, copy_length);
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -1857,14 +1875,14 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                rundest = fdi_copy_match(rundest, runsrc, copy_length);
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
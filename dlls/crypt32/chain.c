@@ -34,6 +34,16 @@ WINE_DEFAULT_DEBUG_CHANNEL(crypt);
 WINE_DECLARE_DEBUG_CHANNEL(chain);
 
 #define DEFAULT_CYCLE_MODULUS 7
+#define SIGNATURE_CACHE_SIZE 256
+
+/* A successful signature check: the SHA1 hash of the subject certificate and
+ * the MD5 hash of the issuer's public key.
+ */
+struct verified_signature
+{
+    BYTE subject_hash[20];
+    BYTE issuer_key_hash[16];
+};
 
 /* This represents a subset of a certificate chain engine:  it doesn't include
  * the "hOther" store described by MSDN, because I'm not sure how that's used.
@@ -49,6 +59,8 @@ typedef struct _CertificateChainEngine
     DWORD      dwUrlRetrievalTimeout;
     DWORD      MaximumCachedCertificates;
     DWORD      CycleDetectionModulus;
+    CRITICAL_SECTION signature_cs;
+    struct verified_signature signature_cache[SIGNATURE_CACHE_SIZE];
 } CertificateChainEngine;
 
 static inline void CRYPT_AddStoresToCollection(HCERTSTORE collection,
@@ -153,6 +165,9 @@ HCERTCHAINENGINE CRYPT_CreateChainEngine(HCERTSTORE root, DWORD system_store, co
         engine->CycleDetectionModulus = config->CycleDetectionModulus;
     else
         engine->CycleDetectionModulus = DEFAULT_CYCLE_MODULUS;
+    InitializeCriticalSection(&engine->signature_cs);
+    engine->signature_cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": CertificateChainEngine.signature_cs");
+    memset(engine->signature_cache, 0, sizeof(engine->signature_cache));
 
     return engine;
 }
@@ -201,6 +216,8 @@ static void free_chain_engine(CertificateChainEngine *engine)
 
     CertCloseStore(engine->hWorld, 0);
     CertCloseStore(engine->hRoot, 0);
+    engine->signature_cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&engine->signature_cs);
     CryptMemFree(engine);
 }
 
@@ -484,20 +501,61 @@ static void CRYPT_CheckTrustedStatus(HCERTSTORE hRoot,
         CertFreeCertificateContext(trustedRoot);
 }
 
-static void CRYPT_CheckRootCert(HCERTSTORE hRoot,
+/* Checks whether subject's signature was made with issuer's key.  Successful
+ * checks are remembered in the engine, keyed by the subject's hash and the
+ * issuer's public key hash, so building another chain through the same
+ * certificates doesn't verify their signatures again.
+ */
+static BOOL CRYPT_VerifyCertSignature(CertificateChainEngine *engine,
+ PCCERT_CONTEXT subject, PCCERT_CONTEXT issuer)
+{
+    struct verified_signature entry, *cached = NULL;
+    DWORD size;
+    BOOL ret;
+
+    size = sizeof(entry.subject_hash);
+    if (CertGetCertificateContextProperty(subject, CERT_HASH_PROP_ID,
+     entry.subject_hash, &size) && size == sizeof(entry.subject_hash))
+    {
+        size = sizeof(entry.issuer_key_hash);
+        if (CertGetCertificateContextProperty(issuer,
+         CERT_SUBJECT_PUBLIC_KEY_MD5_HASH_PROP_ID, entry.issuer_key_hash,
+         &size) && size == sizeof(entry.issuer_key_hash))
+            cached = &engine->signature_cache[entry.subject_hash[0] %
+             SIGNATURE_CACHE_SIZE];
+    }
+    if (cached)
+    {
+        EnterCriticalSection(&engine->signature_cs);
+        ret = !memcmp(cached, &entry, sizeof(entry));
+        LeaveCriticalSection(&engine->signature_cs);
+        if (ret)
+            return TRUE;
+    }
+    ret = CryptVerifyCertificateSignatureEx(0, subject->dwCertEncodingType,
+     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)subject,
+     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)issuer, 0, NULL);
+    if (ret && cached)
+    {
+        EnterCriticalSection(&engine->signature_cs);
+        *cached = entry;
+        LeaveCriticalSection(&engine->signature_cs);
+    }
+    return ret;
+}
+
+static void CRYPT_CheckRootCert(CertificateChainEngine *engine,
  PCERT_CHAIN_ELEMENT rootElement)
 {
     PCCERT_CONTEXT root = rootElement->pCertContext;
 
-    if (!CryptVerifyCertificateSignatureEx(0, root->dwCertEncodingType,
-     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)root,
-     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)root, 0, NULL))
+    if (!CRYPT_VerifyCertSignature(engine, root, root))
     {
         TRACE_(chain)("Last certificate's signature is invalid\n");
         rootElement->TrustStatus.dwErrorStatus |=
          CERT_TRUST_IS_NOT_SIGNATURE_VALID;
     }
-    CRYPT_CheckTrustedStatus(hRoot, rootElement);
+    CRYPT_CheckTrustedStatus(engine->hRoot, rootElement);
 }
 
 /* Decodes a cert's basic constraints extension (either szOID_BASIC_CONSTRAINTS
@@ -1909,11 +1967,9 @@ static void CRYPT_CheckSimpleChain(CertificateChainEngine *engine,
         if (i != 0)
         {
             /* Check the signature of the cert this issued */
-            if (!CryptVerifyCertificateSignatureEx(0, X509_ASN_ENCODING,
-             CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT,
-             (void *)chain->rgpElement[i - 1]->pCertContext,
-             CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT,
-             (void *)chain->rgpElement[i]->pCertContext, 0, NULL))
+            if (!CRYPT_VerifyCertSignature(engine,
+             chain->rgpElement[i - 1]->pCertContext,
+             chain->rgpElement[i]->pCertContext))
                 chain->rgpElement[i - 1]->TrustStatus.dwErrorStatus |=
                  CERT_TRUST_IS_NOT_SIGNATURE_VALID;
             /* Once a path length constraint has been violated, every remaining
@@ -1970,7 +2026,7 @@ static void CRYPT_CheckSimpleChain(CertificateChainEngine *engine,
     if ((status = CRYPT_IsCertificateSelfSigned(rootElement->pCertContext)))
     {
         rootElement->TrustStatus.dwInfoStatus |= status;
-        CRYPT_CheckRootCert(engine->hRoot, rootElement);
+        CRYPT_CheckRootCert(engine, rootElement);
     }
     CRYPT_CombineTrustStatus(&chain->TrustStatus, &rootElement->TrustStatus);
 }
@@ -27,8 +27,126 @@
 
 #include "d3dx9_private.h"
 
+#if (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || __GNUC__ >= 5)
+#define USE_SSE
+#include <intrin.h>
+#endif
+
 WINE_DEFAULT_DEBUG_CHANNEL(d3dx);
 
+#ifdef USE_SSE
+
+static BOOL sse_supported(void)
+{
+#ifdef __x86_64__
+    return TRUE;
+#else
+    static int supported = -1;
+    int regs[4];
+
+    if (supported == -1)
+    {
+        __cpuid(regs, 1);
+        supported = !!(regs[3] & (1 << 25));
+    }
+    return supported;
+#endif
+}
+
+/* The array transforms below compute each output as a linear combination of
+ * the matrix rows, weighted by the input components. The operations are done
+ * in the same order as in the scalar code, so the results match it. */
+
+static inline void __attribute__((target("sse"))) sse_load_matrix(__m128 rows[4], const D3DXMATRIX *m)
+{
+    rows[0] = _mm_loadu_ps(m->m[0]);
+    rows[1] = _mm_loadu_ps(m->m[1]);
+    rows[2] = _mm_loadu_ps(m->m[2]);
+    rows[3] = _mm_loadu_ps(m->m[3]);
+}
+
+static inline __m128 __attribute__((target("sse"))) sse_transform3(const __m128 rows[4], FLOAT x, FLOAT y, FLOAT z)
+{
+    __m128 r;
+
+    r = _mm_mul_ps(rows[0], _mm_set1_ps(x));
+    r = _mm_add_ps(r, _mm_mul_ps(rows[1], _mm_set1_ps(y)));
+    return _mm_add_ps(r, _mm_mul_ps(rows[2], _mm_set1_ps(z)));
+}
+
+static inline void __attribute__((target("sse"))) sse_store_vec3(D3DXVECTOR3 *out, __m128 v)
+{
+    _mm_storel_pi((__m64 *)out, v);
+    _mm_store_ss(&out->z, _mm_movehl_ps(v, v));
+}
+
+static void __attribute__((target("sse"))) sse_vec3_transform_array(D3DXVECTOR4 *out, UINT outstride,
+        const D3DXVECTOR3 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
+{
+    __m128 rows[4], r;
+    UINT i;
+
+    sse_load_matrix(rows, matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 *v = (const D3DXVECTOR3 *)((const char *)in + instride * i);
+
+        r = _mm_add_ps(sse_transform3(rows, v->x, v->y, v->z), rows[3]);
+        _mm_storeu_ps(&((D3DXVECTOR4 *)((char *)out + outstride * i))->x, r);
+    }
+}
+
+static void __attribute__((target("sse"))) sse_vec3_transform_coord_array(D3DXVECTOR3 *out, UINT outstride,
+        const D3DXVECTOR3 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
+{
+    __m128 rows[4], r;
+    UINT i;
+
+    sse_load_matrix(rows, matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 *v = (const D3DXVECTOR3 *)((const char *)in + instride * i);
+
+        r = _mm_add_ps(sse_transform3(rows, v->x, v->y, v->z), rows[3]);
+        r = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+        sse_store_vec3((D3DXVECTOR3 *)((char *)out + outstride * i), r);
+    }
+}
+
+static void __attribute__((target("sse"))) sse_vec3_transform_normal_array(D3DXVECTOR3 *out, UINT outstride,
+        const D3DXVECTOR3 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
+{
+    __m128 rows[4];
+    UINT i;
+
+    sse_load_matrix(rows, matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR3 *v = (const D3DXVECTOR3 *)((const char *)in + instride * i);
+
+        sse_store_vec3((D3DXVECTOR3 *)((char *)out + outstride * i), sse_transform3(rows, v->x, v->y, v->z));
+    }
+}
+
+/* Also used for planes, which have the same layout. */
+static void __attribute__((target("sse"))) sse_vec4_transform_array(D3DXVECTOR4 *out, UINT outstride,
+        const D3DXVECTOR4 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
+{
+    __m128 rows[4], r;
+    UINT i;
+
+    sse_load_matrix(rows, matrix);
+    for (i = 0; i < elements; ++i)
+    {
+        const D3DXVECTOR4 *v = (const D3DXVECTOR4 *)((const char *)in + instride * i);
+
+        r = _mm_add_ps(sse_transform3(rows, v->x, v->y, v->z), _mm_mul_ps(rows[3], _mm_set1_ps(v->w)));
+        _mm_storeu_ps(&((D3DXVECTOR4 *)((char *)out + outstride * i))->x, r);
+    }
+}
+
+#endif /* USE_SSE */
+
 struct ID3DXMatrixStackImpl
 {
   ID3DXMatrixStack ID3DXMatrixStack_iface;
@@ -393,16 +511,21 @@ D3DXMATRIX * WINAPI D3DXMatrixLookAtRH(D3DXMATRIX *out, const D3DXVECTOR3 *eye,
 D3DXMATRIX* WINAPI D3DXMatrixMultiply(D3DXMATRIX *pout, const D3DXMATRIX *pm1, const D3DXMATRIX *pm2)
 {
     D3DXMATRIX out;
-    int i,j;
+    FLOAT a0, a1, a2, a3;
+    int i, j;
 
     TRACE("pout %p, pm1 %p, pm2 %p\n", pout, pm1, pm2);
 
-    for (i=0; i<4; i++)
+    /* Each row of the result is a linear combination of the rows of pm2,
+     * which lets the compiler vectorize the inner loop. */
+    for (i = 0; i < 4; ++i)
     {
-        for (j=0; j<4; j++)
-        {
-            out.m[i][j] = pm1->m[i][0] * pm2->m[0][j] + pm1->m[i][1] * pm2->m[1][j] + pm1->m[i][2] * pm2->m[2][j] + pm1->m[i][3] * pm2->m[3][j];
-        }
+        a0 = pm1->m[i][0];
+        a1 = pm1->m[i][1];
+        a2 = pm1->m[i][2];
+        a3 = pm1->m[i][3];
+        for (j = 0; j < 4; ++j)
+            out.m[i][j] = a0 * pm2->m[0][j] + a1 * pm2->m[1][j] + a2 * pm2->m[2][j] + a3 * pm2->m[3][j];
     }
 
     *pout = out;
@@ -1275,16 +1398,21 @@ D3DXPLANE * WINAPI D3DXPlaneNormalize(D3DXPLANE *out, const D3DXPLANE *p)
     return out;
 }
 
-D3DXPLANE* WINAPI D3DXPlaneTransform(D3DXPLANE *pout, const D3DXPLANE *pplane, const D3DXMATRIX *pm)
+static inline void plane_transform(D3DXPLANE *pout, const D3DXPLANE *pplane, const D3DXMATRIX *pm)
 {
     const D3DXPLANE plane = *pplane;
 
-    TRACE("pout %p, pplane %p, pm %p\n", pout, pplane, pm);
-
     pout->a = pm->m[0][0] * plane.a + pm->m[1][0] * plane.b + pm->m[2][0] * plane.c + pm->m[3][0] * plane.d;
     pout->b = pm->m[0][1] * plane.a + pm->m[1][1] * plane.b + pm->m[2][1] * plane.c + pm->m[3][1] * plane.d;
     pout->c = pm->m[0][2] * plane.a + pm->m[1][2] * plane.b + pm->m[2][2] * plane.c + pm->m[3][2] * plane.d;
     pout->d = pm->m[0][3] * plane.a + pm->m[1][3] * plane.b + pm->m[2][3] * plane.c + pm->m[3][3] * plane.d;
+}
+
+D3DXPLANE* WINAPI D3DXPlaneTransform(D3DXPLANE *pout, const D3DXPLANE *pplane, const D3DXMATRIX *pm)
+{
+    TRACE("pout %p, pplane %p, pm %p\n", pout, pplane, pm);
+
+    plane_transform(pout, pplane, pm);
     return pout;
 }
 
@@ -1294,11 +1422,18 @@ D3DXPLANE* WINAPI D3DXPlaneTransformArray(D3DXPLANE* out, UINT outstride, const
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXPlaneTransform(
-            (D3DXPLANE*)((char*)out + outstride * i),
-            (const D3DXPLANE*)((const char*)in + instride * i),
-            matrix);
+#ifdef USE_SSE
+    if (sse_supported())
+    {
+        sse_vec4_transform_array((D3DXVECTOR4 *)out, outstride, (const D3DXVECTOR4 *)in, instride, matrix, elements);
+        return out;
+    }
+#endif
+
+    for (i = 0; i < elements; ++i)
+    {
+        plane_transform((D3DXPLANE *)((char *)out + outstride * i),
+                (const D3DXPLANE *)((const char *)in + instride * i), matrix);
     }
     return out;
 }
@@ -1825,18 +1960,38 @@ D3DXVECTOR3* WINAPI D3DXVec3Normalize(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv)
     return pout;
 }
 
-D3DXVECTOR3* WINAPI D3DXVec3Project(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DVIEWPORT9 *pviewport, const D3DXMATRIX *pprojection, const D3DXMATRIX *pview, const D3DXMATRIX *pworld)
+static inline void vec3_transform_coord(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
 {
-    D3DXMATRIX m;
+    D3DXVECTOR3 out;
+    FLOAT norm;
 
-    TRACE("pout %p, pv %p, pviewport %p, pprojection %p, pview %p, pworld %p\n", pout, pv, pviewport, pprojection, pview, pworld);
+    norm = pm->m[0][3] * pv->x + pm->m[1][3] * pv->y + pm->m[2][3] *pv->z + pm->m[3][3];
 
-    D3DXMatrixIdentity(&m);
-    if (pworld) D3DXMatrixMultiply(&m, &m, pworld);
-    if (pview) D3DXMatrixMultiply(&m, &m, pview);
-    if (pprojection) D3DXMatrixMultiply(&m, &m, pprojection);
+    out.x = (pm->m[0][0] * pv->x + pm->m[1][0] * pv->y + pm->m[2][0] * pv->z + pm->m[3][0]) / norm;
+    out.y = (pm->m[0][1] * pv->x + pm->m[1][1] * pv->y + pm->m[2][1] * pv->z + pm->m[3][1]) / norm;
+    out.z = (pm->m[0][2] * pv->x + pm->m[1][2] * pv->y + pm->m[2][2] * pv->z + pm->m[3][2]) / norm;
+
+    *pout = out;
+}
 
-    D3DXVec3TransformCoord(pout, pv, &m);
+/* The array functions compute the combined matrix once, rather than once per
+ * element. */
+static void get_project_matrix(D3DXMATRIX *m, const D3DXMATRIX *projection,
+        const D3DXMATRIX *view, const D3DXMATRIX *world)
+{
+    D3DXMatrixIdentity(m);
+    if (world)
+        D3DXMatrixMultiply(m, m, world);
+    if (view)
+        D3DXMatrixMultiply(m, m, view);
+    if (projection)
+        D3DXMatrixMultiply(m, m, projection);
+}
+
+static inline void vec3_project(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv,
+        const D3DVIEWPORT9 *pviewport, const D3DXMATRIX *m)
+{
+    vec3_transform_coord(pout, pv, m);
 
     if (pviewport)
     {
@@ -1844,36 +1999,52 @@ D3DXVECTOR3* WINAPI D3DXVec3Project(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, co
         pout->y = pviewport->Y +  ( 1.0f - pout->y ) * pviewport->Height / 2.0f;
         pout->z = pviewport->MinZ + pout->z * ( pviewport->MaxZ - pviewport->MinZ );
     }
+}
+
+D3DXVECTOR3* WINAPI D3DXVec3Project(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DVIEWPORT9 *pviewport, const D3DXMATRIX *pprojection, const D3DXMATRIX *pview, const D3DXMATRIX *pworld)
+{
+    D3DXMATRIX m;
+
+    TRACE("pout %p, pv %p, pviewport %p, pprojection %p, pview %p, pworld %p\n", pout, pv, pviewport, pprojection, pview, pworld);
+
+    get_project_matrix(&m, pprojection, pview, pworld);
+    vec3_project(pout, pv, pviewport, &m);
     return pout;
 }
 
 D3DXVECTOR3* WINAPI D3DXVec3ProjectArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DVIEWPORT9* viewport, const D3DXMATRIX* projection, const D3DXMATRIX* view, const D3DXMATRIX* world, UINT elements)
 {
+    D3DXMATRIX m;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, viewport %p, projection %p, view %p, world %p, elements %u\n",
         out, outstride, in, instride, viewport, projection, view, world, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3Project(
-            (D3DXVECTOR3*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            viewport, projection, view, world);
+    get_project_matrix(&m, projection, view, world);
+    for (i = 0; i < elements; ++i)
+    {
+        vec3_project((D3DXVECTOR3 *)((char *)out + outstride * i),
+                (const D3DXVECTOR3 *)((const char *)in + instride * i), viewport, &m);
     }
     return out;
 }
 
-D3DXVECTOR4* WINAPI D3DXVec3Transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+static inline void vec3_transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
 {
     D3DXVECTOR4 out;
 
-    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
-
     out.x = pm->m[0][0] * pv->x + pm->m[1][0] * pv->y + pm->m[2][0] * pv->z + pm->m[3][0];
     out.y = pm->m[0][1] * pv->x + pm->m[1][1] * pv->y + pm->m[2][1] * pv->z + pm->m[3][1];
     out.z = pm->m[0][2] * pv->x + pm->m[1][2] * pv->y + pm->m[2][2] * pv->z + pm->m[3][2];
     out.w = pm->m[0][3] * pv->x + pm->m[1][3] * pv->y + pm->m[2][3] * pv->z + pm->m[3][3];
     *pout = out;
+}
+
+D3DXVECTOR4* WINAPI D3DXVec3Transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+{
+    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
+
+    vec3_transform(pout, pv, pm);
     return pout;
 }
 
@@ -1883,30 +2054,27 @@ D3DXVECTOR4* WINAPI D3DXVec3TransformArray(D3DXVECTOR4* out, UINT outstride, con
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3Transform(
-            (D3DXVECTOR4*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+#ifdef USE_SSE
+    if (sse_supported())
+    {
+        sse_vec3_transform_array(out, outstride, in, instride, matrix, elements);
+        return out;
+    }
+#endif
+
+    for (i = 0; i < elements; ++i)
+    {
+        vec3_transform((D3DXVECTOR4 *)((char *)out + outstride * i),
+                (const D3DXVECTOR3 *)((const char *)in + instride * i), matrix);
     }
     return out;
 }
 
 D3DXVECTOR3* WINAPI D3DXVec3TransformCoord(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
 {
-    D3DXVECTOR3 out;
-    FLOAT norm;
-
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    norm = pm->m[0][3] * pv->x + pm->m[1][3] * pv->y + pm->m[2][3] *pv->z + pm->m[3][3];
-
-    out.x = (pm->m[0][0] * pv->x + pm->m[1][0] * pv->y + pm->m[2][0] * pv->z + pm->m[3][0]) / norm;
-    out.y = (pm->m[0][1] * pv->x + pm->m[1][1] * pv->y + pm->m[2][1] * pv->z + pm->m[3][1]) / norm;
-    out.z = (pm->m[0][2] * pv->x + pm->m[1][2] * pv->y + pm->m[2][2] * pv->z + pm->m[3][2]) / norm;
-
-    *pout = out;
-
+    vec3_transform_coord(pout, pv, pm);
     return pout;
 }
 
@@ -1916,11 +2084,18 @@ D3DXVECTOR3* WINAPI D3DXVec3TransformCoordArray(D3DXVECTOR3* out, UINT outstride
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3TransformCoord(
-            (D3DXVECTOR3*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+#ifdef USE_SSE
+    if (sse_supported())
+    {
+        sse_vec3_transform_coord_array(out, outstride, in, instride, matrix, elements);
+        return out;
+    }
+#endif
+
+    for (i = 0; i < elements; ++i)
+    {
+        vec3_transform_coord((D3DXVECTOR3 *)((char *)out + outstride * i),
+                (const D3DXVECTOR3 *)((const char *)in + instride * i), matrix);
     }
     return out;
 }
@@ -1944,6 +2119,14 @@ D3DXVECTOR3* WINAPI D3DXVec3TransformNormalArray(D3DXVECTOR3* out, UINT outstrid
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
+#ifdef USE_SSE
+    if (sse_supported())
+    {
+        sse_vec3_transform_normal_array(out, outstride, in, instride, matrix, elements);
+        return out;
+    }
+#endif
+
     for (i = 0; i < elements; ++i) {
         D3DXVec3TransformNormal(
             (D3DXVECTOR3*)((char*)out + outstride * i),
@@ -1953,6 +2136,19 @@ D3DXVECTOR3* WINAPI D3DXVec3TransformNormalArray(D3DXVECTOR3* out, UINT outstrid
     return out;
 }
 
+static inline void vec3_unproject(D3DXVECTOR3 *out, const D3DXVECTOR3 *v,
+        const D3DVIEWPORT9 *viewport, const D3DXMATRIX *inverse)
+{
+    *out = *v;
+    if (viewport)
+    {
+        out->x = 2.0f * (out->x - viewport->X) / viewport->Width - 1.0f;
+        out->y = 1.0f - 2.0f * (out->y - viewport->Y) / viewport->Height;
+        out->z = (out->z - viewport->MinZ) / (viewport->MaxZ - viewport->MinZ);
+    }
+    vec3_transform_coord(out, out, inverse);
+}
+
 D3DXVECTOR3 * WINAPI D3DXVec3Unproject(D3DXVECTOR3 *out, const D3DXVECTOR3 *v,
         const D3DVIEWPORT9 *viewport, const D3DXMATRIX *projection, const D3DXMATRIX *view,
         const D3DXMATRIX *world)
@@ -1962,38 +2158,26 @@ D3DXVECTOR3 * WINAPI D3DXVec3Unproject(D3DXVECTOR3 *out, const D3DXVECTOR3 *v,
     TRACE("out %p, v %p, viewport %p, projection %p, view %p, world %p.\n",
             out, v, viewport, projection, view, world);
 
-    D3DXMatrixIdentity(&m);
-    if (world)
-        D3DXMatrixMultiply(&m, &m, world);
-    if (view)
-        D3DXMatrixMultiply(&m, &m, view);
-    if (projection)
-        D3DXMatrixMultiply(&m, &m, projection);
+    get_project_matrix(&m, projection, view, world);
     D3DXMatrixInverse(&m, NULL, &m);
-
-    *out = *v;
-    if (viewport)
-    {
-        out->x = 2.0f * (out->x - viewport->X) / viewport->Width - 1.0f;
-        out->y = 1.0f - 2.0f * (out->y - viewport->Y) / viewport->Height;
-        out->z = (out->z - viewport->MinZ) / (viewport->MaxZ - viewport->MinZ);
-    }
-    D3DXVec3TransformCoord(out, out, &m);
+    vec3_unproject(out, v, viewport, &m);
     return out;
 }
 
 D3DXVECTOR3* WINAPI D3DXVec3UnprojectArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DVIEWPORT9* viewport, const D3DXMATRIX* projection, const D3DXMATRIX* view, const D3DXMATRIX* world, UINT elements)
 {
+    D3DXMATRIX m;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, viewport %p, projection %p, view %p, world %p, elements %u\n",
         out, outstride, in, instride, viewport, projection, view, world, elements);
 
-    for (i = 0; i < elements; ++i) {
-        D3DXVec3Unproject(
-            (D3DXVECTOR3*)((char*)out + outstride * i),
-            (const D3DXVECTOR3*)((const char*)in + instride * i),
-            viewport, projection, view, world);
+    get_project_matrix(&m, projection, view, world);
+    D3DXMatrixInverse(&m, NULL, &m);
+    for (i = 0; i < elements; ++i)
+    {
+        vec3_unproject((D3DXVECTOR3 *)((char *)out + outstride * i),
+                (const D3DXVECTOR3 *)((const char *)in + instride * i), viewport, &m);
     }
     return out;
 }
@@ -2090,6 +2274,14 @@ D3DXVECTOR4* WINAPI D3DXVec4TransformArray(D3DXVECTOR4* out, UINT outstride, con
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
+#ifdef USE_SSE
+    if (sse_supported())
+    {
+        sse_vec4_transform_array(out, outstride, in, instride, matrix, elements);
+        return out;
+    }
+#endif
+
     for (i = 0; i < elements; ++i) {
         D3DXVec4Transform(
             (D3DXVECTOR4*)((char*)out + outstride * i),
@@ -1624,6 +1624,165 @@ static HRESULT remap_faces_for_attrsort(struct d3dx9_mesh *This, const DWORD *in
     return D3D_OK;
 }
 
+#define VERTEX_CACHE_SIZE 32
+
+/* Vertex scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation":
+ * vertices which are already in the simulated cache, and vertices with few
+ * faces left to draw, are preferred. */
+static float vertex_cache_score(int cache_position, unsigned int remaining_faces)
+{
+    float score = 0.0f;
+
+    if (!remaining_faces)
+        return -1.0f;
+
+    if (cache_position >= 0)
+    {
+        if (cache_position < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - (cache_position - 3) * (1.0f / (VERTEX_CACHE_SIZE - 3)), 1.5f);
+    }
+
+    return score + 2.0f / sqrtf(remaining_faces);
+}
+
+/* Reorders the faces within each attribute range for the post-transform
+ * vertex cache. face_order holds the old face index for each new position
+ * and is expected to be sorted by attribute already; it is updated in place.
+ * The work is linear in the number of faces: candidate faces are only looked
+ * up through the vertices currently in the cache, and when none is left the
+ * next face in the original order is used. */
+static HRESULT optimize_faces_for_vertex_cache(const DWORD *indices, const DWORD *attrib_buffer,
+        DWORD num_faces, DWORD num_vertices, DWORD *face_order)
+{
+    DWORD *vertex_faces = NULL, *vertex_face_start = NULL, *remaining = NULL, *new_order = NULL;
+    unsigned int cache[VERTEX_CACHE_SIZE + 3], cache_size = 0;
+    int *cache_position = NULL;
+    BOOL *emitted = NULL;
+    DWORD start, end, i, j, k;
+    HRESULT hr = E_OUTOFMEMORY;
+
+    if (!(vertex_face_start = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, (num_vertices + 1) * sizeof(*vertex_face_start)))
+            || !(vertex_faces = HeapAlloc(GetProcessHeap(), 0, 3 * num_faces * sizeof(*vertex_faces)))
+            || !(remaining = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_vertices * sizeof(*remaining)))
+            || !(cache_position = HeapAlloc(GetProcessHeap(), 0, num_vertices * sizeof(*cache_position)))
+            || !(emitted = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_faces * sizeof(*emitted)))
+            || !(new_order = HeapAlloc(GetProcessHeap(), 0, num_faces * sizeof(*new_order))))
+        goto cleanup;
+
+    for (i = 0; i < 3 * num_faces; ++i)
+    {
+        if (indices[i] >= num_vertices)
+        {
+            WARN("Index %lu out of bounds, vertex count %lu.\n", indices[i], num_vertices);
+            hr = D3DERR_INVALIDCALL;
+            goto cleanup;
+        }
+        ++vertex_face_start[indices[i] + 1];
+    }
+    for (i = 0; i < num_vertices; ++i)
+    {
+        vertex_face_start[i + 1] += vertex_face_start[i];
+        cache_position[i] = -1;
+    }
+    for (i = 0; i < 3 * num_faces; ++i)
+        vertex_faces[vertex_face_start[indices[i]] + remaining[indices[i]]++] = i / 3;
+    memset(remaining, 0, num_vertices * sizeof(*remaining));
+
+    for (start = 0; start < num_faces; start = end)
+    {
+        DWORD attribute = attrib_buffer[face_order[start]];
+        DWORD next = start, best_face = ~0u;
+
+        for (end = start; end < num_faces && attrib_buffer[face_order[end]] == attribute; ++end)
+        {
+            for (j = 0; j < 3; ++j)
+                ++remaining[indices[3 * face_order[end] + j]];
+        }
+
+        for (i = start; i < end; ++i)
+        {
+            unsigned int new_cache_size = 3;
+            float best_score = -1.0f;
+
+            if (best_face == ~0u)
+            {
+                while (emitted[face_order[next]])
+                    ++next;
+                best_face = face_order[next];
+            }
+
+            new_order[i] = best_face;
+            emitted[best_face] = TRUE;
+
+            /* Put the face's vertices in front of the cache, in draw order,
+             * followed by the previous cache entries. */
+            memmove(cache + 3, cache, cache_size * sizeof(*cache));
+            for (j = 0; j < 3; ++j)
+            {
+                cache[j] = indices[3 * best_face + j];
+                --remaining[cache[j]];
+            }
+            for (j = 3; j < cache_size + 3; ++j)
+            {
+                if (cache[j] != cache[0] && cache[j] != cache[1] && cache[j] != cache[2])
+                    cache[new_cache_size++] = cache[j];
+            }
+            cache_size = new_cache_size;
+
+            for (j = 0; j < cache_size; ++j)
+                cache_position[cache[j]] = j < VERTEX_CACHE_SIZE ? j : -1;
+            cache_size = min(cache_size, VERTEX_CACHE_SIZE);
+
+            /* Pick the best face among those touching a cached vertex. */
+            best_face = ~0u;
+            for (j = 0; j < cache_size; ++j)
+            {
+                DWORD vertex = cache[j];
+
+                if (!remaining[vertex])
+                    continue;
+
+                for (k = vertex_face_start[vertex]; k < vertex_face_start[vertex + 1]; ++k)
+                {
+                    DWORD face = vertex_faces[k];
+                    const DWORD *face_indices = indices + 3 * face;
+                    float score = 0.0f;
+                    unsigned int l;
+
+                    if (emitted[face] || attrib_buffer[face] != attribute)
+                        continue;
+
+                    for (l = 0; l < 3; ++l)
+                        score += vertex_cache_score(cache_position[face_indices[l]], remaining[face_indices[l]]);
+                    if (score > best_score)
+                    {
+                        best_score = score;
+                        best_face = face;
+                    }
+                }
+            }
+        }
+
+        for (j = 0; j < cache_size; ++j)
+            cache_position[cache[j]] = -1;
+        cache_size = 0;
+    }
+
+    memcpy(face_order, new_order, num_faces * sizeof(*face_order));
+    hr = D3D_OK;
+
+cleanup:
+    HeapFree(GetProcessHeap(), 0, new_order);
+    HeapFree(GetProcessHeap(), 0, emitted);
+    HeapFree(GetProcessHeap(), 0, cache_position);
+    HeapFree(GetProcessHeap(), 0, remaining);
+    HeapFree(GetProcessHeap(), 0, vertex_faces);
+    HeapFree(GetProcessHeap(), 0, vertex_face_start);
+    return hr;
+}
+
 static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags, const DWORD *adjacency_in,
         DWORD *adjacency_out, DWORD *face_remap_out, ID3DXBuffer **vertex_remap_out)
 {
@@ -1650,14 +1809,14 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
     if ((flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER)) == (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
         return D3DERR_INVALIDCALL;
 
-    if (flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
+    if (flags & D3DXMESHOPT_STRIPREORDER)
     {
-        if (flags & D3DXMESHOPT_VERTEXCACHE)
-            FIXME("D3DXMESHOPT_VERTEXCACHE not implemented.\n");
-        if (flags & D3DXMESHOPT_STRIPREORDER)
-            FIXME("D3DXMESHOPT_STRIPREORDER not implemented.\n");
+        FIXME("D3DXMESHOPT_STRIPREORDER not implemented.\n");
         return E_NOTIMPL;
     }
+    /* Vertex cache optimization implies attribute sorting. */
+    if (flags & D3DXMESHOPT_VERTEXCACHE)
+        flags |= D3DXMESHOPT_ATTRSORT;
 
     hr = iface->lpVtbl->LockIndexBuffer(iface, 0, &indices);
     if (FAILED(hr)) goto cleanup;
@@ -1686,6 +1845,28 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
 
         hr = remap_faces_for_attrsort(This, dword_indices, attrib_buffer, &sorted_attrib_buffer, &face_remap);
         if (FAILED(hr)) goto cleanup;
+
+        if (flags & D3DXMESHOPT_VERTEXCACHE)
+        {
+            DWORD *face_order;
+
+            if (!(face_order = HeapAlloc(GetProcessHeap(), 0, This->numfaces * sizeof(*face_order))))
+            {
+                hr = E_OUTOFMEMORY;
+                goto cleanup;
+            }
+            for (i = 0; i < This->numfaces; i++)
+                face_order[face_remap[i]] = i;
+            hr = optimize_faces_for_vertex_cache(dword_indices, attrib_buffer,
+                    This->numfaces, This->numvertices, face_order);
+            if (SUCCEEDED(hr))
+            {
+                for (i = 0; i < This->numfaces; i++)
+                    face_remap[face_order[i]] = i;
+            }
+            HeapFree(GetProcessHeap(), 0, face_order);
+            if (FAILED(hr)) goto cleanup;
+        }
     }
 
     if (vertex_remap)
@@ -399,10 +399,90 @@ static HRESULT WINAPI d3dx9_skin_info_GetDeclaration(ID3DXSkinInfo *iface,
 static HRESULT WINAPI d3dx9_skin_info_UpdateSkinnedMesh(ID3DXSkinInfo *iface, const D3DXMATRIX *bone_transforms,
         const D3DXMATRIX *bone_inv_transpose_transforms, const void *src_vertices, void *dst_vertices)
 {
-    FIXME("iface %p, bone_transforms %p, bone_inv_transpose_transforms %p, src_vertices %p, dst_vertices %p stub!\n",
+    struct d3dx9_skin_info *skin = impl_from_ID3DXSkinInfo(iface);
+    DWORD stride = skin->fvf & D3DFVF_NORMAL ? 2 : 1;
+    const BYTE *src = src_vertices;
+    BYTE *dst = dst_vertices;
+    D3DXVECTOR3 *accum;
+    DWORD size, i, j;
+
+    TRACE("iface %p, bone_transforms %p, bone_inv_transpose_transforms %p, src_vertices %p, dst_vertices %p.\n",
             iface, bone_transforms, bone_inv_transpose_transforms, src_vertices, dst_vertices);
 
-    return E_NOTIMPL;
+    if (!bone_transforms || !src_vertices || !dst_vertices)
+        return D3DERR_INVALIDCALL;
+
+    if ((skin->fvf & D3DFVF_POSITION_MASK) != D3DFVF_XYZ)
+    {
+        FIXME("Vertex type %#lx not supported.\n", skin->fvf & D3DFVF_POSITION_MASK);
+        return E_FAIL;
+    }
+
+    size = D3DXGetFVFVertexSize(skin->fvf);
+
+    /* Positions, and the normals that directly follow them, are accumulated
+     * from every influencing bone. Vertices without any influence end up at
+     * the origin. The sums are kept aside until all the bones have been
+     * applied, since the source and destination vertices may be the same. */
+    if (!(accum = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, skin->num_vertices * stride * sizeof(*accum))))
+        return E_OUTOFMEMORY;
+
+    /* Walk the influences bone by bone, so that each matrix is only looked up
+     * once and stays hot while all the vertices it moves are processed. */
+    for (i = 0; i < skin->num_bones; ++i)
+    {
+        const struct bone *bone = &skin->bones[i];
+        const D3DXMATRIX *position_matrix = &bone_transforms[i];
+        const D3DXMATRIX *normal_matrix = bone_inv_transpose_transforms
+                ? &bone_inv_transpose_transforms[i] : position_matrix;
+
+        for (j = 0; j < bone->num_influences; ++j)
+        {
+            DWORD vertex = bone->vertices[j];
+            const D3DXVECTOR3 *src_position;
+            D3DXVECTOR3 *sum, v;
+            float weight;
+
+            if (vertex >= skin->num_vertices)
+                continue;
+
+            src_position = (const D3DXVECTOR3 *)(src + size * vertex);
+            sum = &accum[vertex * stride];
+            weight = bone->weights[j];
+
+            D3DXVec3TransformCoord(&v, src_position, position_matrix);
+            sum[0].x += weight * v.x;
+            sum[0].y += weight * v.y;
+            sum[0].z += weight * v.z;
+
+            if (stride > 1)
+            {
+                D3DXVec3TransformNormal(&v, src_position + 1, normal_matrix);
+                sum[1].x += weight * v.x;
+                sum[1].y += weight * v.y;
+                sum[1].z += weight * v.z;
+            }
+        }
+    }
+
+    for (i = 0; i < skin->num_vertices; ++i)
+    {
+        D3DXVECTOR3 *position = (D3DXVECTOR3 *)(dst + size * i);
+
+        position[0] = accum[i * stride];
+        if (stride > 1)
+        {
+            D3DXVECTOR3 *normal = &accum[i * stride + 1];
+
+            if (normal->x || normal->y || normal->z)
+                D3DXVec3Normalize(&position[1], normal);
+            else
+                position[1] = *normal;
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, accum);
+    return D3D_OK;
 }
 
 static HRESULT WINAPI d3dx9_skin_info_ConvertToBlendedMesh(ID3DXSkinInfo *iface, ID3DXMesh *mesh_in,
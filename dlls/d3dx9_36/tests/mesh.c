@@ -5251,6 +5251,79 @@ static void test_create_skin_info(void)
     ok(hr == D3DERR_INVALIDCALL, "Expected D3DERR_INVALIDCALL, got %#x\n", hr);
 }
 
+static void test_update_skinned_mesh(void)
+{
+    static const struct
+    {
+        D3DXVECTOR3 position;
+        D3DXVECTOR3 normal;
+    }
+    src[] =
+    {
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},
+    },
+    expected[] =
+    {
+        {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{2.0f, 1.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, 2.0f}, {1.0f, 0.0f, 0.0f}},
+    };
+    static const DWORD bone0_vertices[] = {0, 1}, bone1_vertices[] = {1, 2};
+    static const FLOAT bone0_weights[] = {1.0f, 0.5f}, bone1_weights[] = {0.5f, 1.0f};
+    struct
+    {
+        D3DXVECTOR3 position;
+        D3DXVECTOR3 normal;
+    }
+    dst[ARRAY_SIZE(src)];
+    ID3DXSkinInfo *skininfo;
+    D3DXMATRIX transforms[2];
+    unsigned int i;
+    HRESULT hr;
+
+    hr = D3DXCreateSkinInfoFVF(ARRAY_SIZE(src), D3DFVF_XYZ | D3DFVF_NORMAL, 2, &skininfo);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    hr = skininfo->lpVtbl->SetBoneInfluence(skininfo, 0, ARRAY_SIZE(bone0_vertices), bone0_vertices, bone0_weights);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = skininfo->lpVtbl->SetBoneInfluence(skininfo, 1, ARRAY_SIZE(bone1_vertices), bone1_vertices, bone1_weights);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    D3DXMatrixTranslation(&transforms[0], 1.0f, 0.0f, 0.0f);
+    D3DXMatrixScaling(&transforms[1], 2.0f, 2.0f, 2.0f);
+
+    memset(dst, 0xcc, sizeof(dst));
+    hr = skininfo->lpVtbl->UpdateSkinnedMesh(skininfo, transforms, NULL, src, dst);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(dst); ++i)
+    {
+        ok(compare_vec3(dst[i].position, expected[i].position),
+                "Vertex %u: got unexpected position {%.8e, %.8e, %.8e}.\n",
+                i, dst[i].position.x, dst[i].position.y, dst[i].position.z);
+        ok(compare_vec3(dst[i].normal, expected[i].normal),
+                "Vertex %u: got unexpected normal {%.8e, %.8e, %.8e}.\n",
+                i, dst[i].normal.x, dst[i].normal.y, dst[i].normal.z);
+    }
+
+    /* In-place update. */
+    memcpy(dst, src, sizeof(dst));
+    hr = skininfo->lpVtbl->UpdateSkinnedMesh(skininfo, transforms, NULL, dst, dst);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(dst); ++i)
+    {
+        ok(compare_vec3(dst[i].position, expected[i].position),
+                "Vertex %u: got unexpected position {%.8e, %.8e, %.8e}.\n",
+                i, dst[i].position.x, dst[i].position.y, dst[i].position.z);
+        ok(compare_vec3(dst[i].normal, expected[i].normal),
+                "Vertex %u: got unexpected normal {%.8e, %.8e, %.8e}.\n",
+                i, dst[i].normal.x, dst[i].normal.y, dst[i].normal.z);
+    }
+
+    IUnknown_Release(skininfo);
+}
+
 static void test_convert_adjacency_to_point_reps(void)
 {
     HRESULT hr;
@@ -10542,6 +10615,228 @@ static void test_optimize_faces(void)
     ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
 }
 
+#define VERTEX_CACHE_GRID_SIZE 4
+
+/* Checks a mesh optimized with D3DXMESHOPT_VERTEXCACHE against the original
+ * grid built by test_optimize_vertex_cache(). */
+static void check_vertex_cache_mesh(ID3DXMesh *mesh, const D3DXVECTOR3 *orig_vertices,
+        const WORD *orig_indices, const DWORD *orig_attribs, DWORD num_attribs,
+        const DWORD *face_remap, ID3DXBuffer *vertex_remap_buffer)
+{
+    const DWORD num_faces = 2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE;
+    const DWORD num_vertices = (VERTEX_CACHE_GRID_SIZE + 1) * (VERTEX_CACHE_GRID_SIZE + 1);
+    BOOL seen_faces[2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE] = {0};
+    BOOL seen_vertices[(VERTEX_CACHE_GRID_SIZE + 1) * (VERTEX_CACHE_GRID_SIZE + 1)] = {0};
+    D3DXATTRIBUTERANGE attrib_table[4];
+    DWORD attrib_table_size, face_start;
+    const DWORD *vertex_remap;
+    D3DXVECTOR3 *vertices;
+    DWORD *attribs;
+    WORD *indices;
+    unsigned int i, j;
+    HRESULT hr;
+
+    ok(mesh->lpVtbl->GetNumFaces(mesh) == num_faces, "Got unexpected face count %u.\n",
+            mesh->lpVtbl->GetNumFaces(mesh));
+    ok(mesh->lpVtbl->GetNumVertices(mesh) == num_vertices, "Got unexpected vertex count %u.\n",
+            mesh->lpVtbl->GetNumVertices(mesh));
+
+    /* The face remap is a permutation which keeps faces within their attribute range. */
+    hr = mesh->lpVtbl->LockAttributeBuffer(mesh, D3DLOCK_READONLY, &attribs);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < num_faces; ++i)
+    {
+        ok(face_remap[i] < num_faces, "Face %u: got unexpected remap %u.\n", i, face_remap[i]);
+        if (face_remap[i] >= num_faces)
+            continue;
+        ok(!seen_faces[face_remap[i]], "Face %u: old face %u is used twice.\n", i, face_remap[i]);
+        seen_faces[face_remap[i]] = TRUE;
+        ok(attribs[i] == orig_attribs[face_remap[i]], "Face %u: got attribute %u, expected %u.\n",
+                i, attribs[i], orig_attribs[face_remap[i]]);
+        if (i)
+            ok(attribs[i] >= attribs[i - 1], "Face %u: attributes are not sorted, %u after %u.\n",
+                    i, attribs[i], attribs[i - 1]);
+    }
+    mesh->lpVtbl->UnlockAttributeBuffer(mesh);
+
+    /* Attribute sorting also builds the attribute table. */
+    hr = mesh->lpVtbl->GetAttributeTable(mesh, NULL, &attrib_table_size);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    ok(attrib_table_size == num_attribs, "Got unexpected attribute table size %u.\n", attrib_table_size);
+    if (attrib_table_size == num_attribs)
+    {
+        hr = mesh->lpVtbl->GetAttributeTable(mesh, attrib_table, &attrib_table_size);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        for (i = 0, face_start = 0; i < attrib_table_size; ++i)
+        {
+            ok(attrib_table[i].AttribId == i, "Range %u: got unexpected attribute %u.\n",
+                    i, attrib_table[i].AttribId);
+            ok(attrib_table[i].FaceStart == face_start, "Range %u: got unexpected face start %u.\n",
+                    i, attrib_table[i].FaceStart);
+            ok(attrib_table[i].FaceCount == num_faces / num_attribs, "Range %u: got unexpected face count %u.\n",
+                    i, attrib_table[i].FaceCount);
+            face_start += attrib_table[i].FaceCount;
+        }
+    }
+
+    /* The vertex remap is a permutation, and the vertices and indices agree with it. */
+    ok(!!vertex_remap_buffer, "Got NULL vertex remap.\n");
+    if (!vertex_remap_buffer)
+        return;
+    ok(ID3DXBuffer_GetBufferSize(vertex_remap_buffer) >= num_vertices * sizeof(DWORD),
+            "Got unexpected vertex remap size %u.\n", ID3DXBuffer_GetBufferSize(vertex_remap_buffer));
+    vertex_remap = ID3DXBuffer_GetBufferPointer(vertex_remap_buffer);
+
+    hr = mesh->lpVtbl->LockVertexBuffer(mesh, D3DLOCK_READONLY, (void **)&vertices);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < num_vertices; ++i)
+    {
+        ok(vertex_remap[i] < num_vertices, "Vertex %u: got unexpected remap %u.\n", i, vertex_remap[i]);
+        if (vertex_remap[i] >= num_vertices)
+            continue;
+        ok(!seen_vertices[vertex_remap[i]], "Vertex %u: old vertex %u is used twice.\n", i, vertex_remap[i]);
+        seen_vertices[vertex_remap[i]] = TRUE;
+        ok(compare_vec3(vertices[i], orig_vertices[vertex_remap[i]]),
+                "Vertex %u: got unexpected position {%.8e, %.8e, %.8e}.\n",
+                i, vertices[i].x, vertices[i].y, vertices[i].z);
+    }
+    mesh->lpVtbl->UnlockVertexBuffer(mesh);
+
+    hr = mesh->lpVtbl->LockIndexBuffer(mesh, D3DLOCK_READONLY, (void **)&indices);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < num_faces; ++i)
+    {
+        const WORD *orig_face;
+        BOOL match = FALSE;
+
+        if (face_remap[i] >= num_faces)
+            continue;
+        orig_face = orig_indices + 3 * face_remap[i];
+
+        /* The winding has to be kept, but the first vertex of a face may change. */
+        for (j = 0; j < 3 && !match; ++j)
+        {
+            match = indices[3 * i] < num_vertices && indices[3 * i + 1] < num_vertices
+                    && indices[3 * i + 2] < num_vertices
+                    && vertex_remap[indices[3 * i]] == orig_face[j]
+                    && vertex_remap[indices[3 * i + 1]] == orig_face[(j + 1) % 3]
+                    && vertex_remap[indices[3 * i + 2]] == orig_face[(j + 2) % 3];
+        }
+        ok(match, "Face %u: got indices {%u, %u, %u}, original face %u is {%u, %u, %u}.\n",
+                i, indices[3 * i], indices[3 * i + 1], indices[3 * i + 2],
+                face_remap[i], orig_face[0], orig_face[1], orig_face[2]);
+    }
+    mesh->lpVtbl->UnlockIndexBuffer(mesh);
+}
+
+static void test_optimize_vertex_cache(void)
+{
+    const DWORD num_faces = 2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE;
+    const DWORD num_vertices = (VERTEX_CACHE_GRID_SIZE + 1) * (VERTEX_CACHE_GRID_SIZE + 1);
+    const DWORD num_attribs = 2;
+    D3DXVECTOR3 orig_vertices[(VERTEX_CACHE_GRID_SIZE + 1) * (VERTEX_CACHE_GRID_SIZE + 1)];
+    WORD orig_indices[3 * 2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE];
+    DWORD orig_attribs[2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE];
+    DWORD face_remap[2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE];
+    DWORD adjacency[3 * 2 * VERTEX_CACHE_GRID_SIZE * VERTEX_CACHE_GRID_SIZE];
+    ID3DXBuffer *vertex_remap;
+    struct test_context *test_context;
+    ID3DXMesh *mesh, *optimized_mesh;
+    D3DXVECTOR3 *vertices;
+    DWORD *attribs;
+    WORD *indices;
+    unsigned int i, x, y;
+    HRESULT hr;
+
+    if (!(test_context = new_test_context()))
+    {
+        skip("Couldn't create test context.\n");
+        return;
+    }
+
+    /* A grid of quads split in two triangles, with interleaved attributes so
+     * that attribute sorting has to move faces around. */
+    for (y = 0; y <= VERTEX_CACHE_GRID_SIZE; ++y)
+    {
+        for (x = 0; x <= VERTEX_CACHE_GRID_SIZE; ++x)
+        {
+            orig_vertices[y * (VERTEX_CACHE_GRID_SIZE + 1) + x].x = x;
+            orig_vertices[y * (VERTEX_CACHE_GRID_SIZE + 1) + x].y = y;
+            orig_vertices[y * (VERTEX_CACHE_GRID_SIZE + 1) + x].z = 0.0f;
+        }
+    }
+    for (y = 0, i = 0; y < VERTEX_CACHE_GRID_SIZE; ++y)
+    {
+        for (x = 0; x < VERTEX_CACHE_GRID_SIZE; ++x, i += 2)
+        {
+            WORD v = y * (VERTEX_CACHE_GRID_SIZE + 1) + x;
+
+            orig_indices[3 * i] = v;
+            orig_indices[3 * i + 1] = v + VERTEX_CACHE_GRID_SIZE + 1;
+            orig_indices[3 * i + 2] = v + 1;
+            orig_indices[3 * i + 3] = v + 1;
+            orig_indices[3 * i + 4] = v + VERTEX_CACHE_GRID_SIZE + 1;
+            orig_indices[3 * i + 5] = v + VERTEX_CACHE_GRID_SIZE + 2;
+            orig_attribs[i] = (x + y) % num_attribs;
+            orig_attribs[i + 1] = (x + y + 1) % num_attribs;
+        }
+    }
+
+    hr = D3DXCreateMeshFVF(num_faces, num_vertices, D3DXMESH_MANAGED, D3DFVF_XYZ, test_context->device, &mesh);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    hr = mesh->lpVtbl->LockVertexBuffer(mesh, 0, (void **)&vertices);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    memcpy(vertices, orig_vertices, sizeof(orig_vertices));
+    mesh->lpVtbl->UnlockVertexBuffer(mesh);
+    hr = mesh->lpVtbl->LockIndexBuffer(mesh, 0, (void **)&indices);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    memcpy(indices, orig_indices, sizeof(orig_indices));
+    mesh->lpVtbl->UnlockIndexBuffer(mesh);
+    hr = mesh->lpVtbl->LockAttributeBuffer(mesh, 0, &attribs);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    memcpy(attribs, orig_attribs, sizeof(orig_attribs));
+    mesh->lpVtbl->UnlockAttributeBuffer(mesh);
+
+    hr = mesh->lpVtbl->GenerateAdjacency(mesh, 0.0f, adjacency);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    /* Adjacency is required. */
+    hr = mesh->lpVtbl->OptimizeInplace(mesh, D3DXMESHOPT_VERTEXCACHE, NULL, NULL, NULL, NULL);
+    ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
+
+    optimized_mesh = NULL;
+    vertex_remap = NULL;
+    memset(face_remap, 0xcc, sizeof(face_remap));
+    hr = mesh->lpVtbl->Optimize(mesh, D3DXMESHOPT_VERTEXCACHE, adjacency, NULL,
+            face_remap, &vertex_remap, &optimized_mesh);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    if (SUCCEEDED(hr))
+    {
+        check_vertex_cache_mesh(optimized_mesh, orig_vertices, orig_indices, orig_attribs,
+                num_attribs, face_remap, vertex_remap);
+        optimized_mesh->lpVtbl->Release(optimized_mesh);
+        if (vertex_remap)
+            ID3DXBuffer_Release(vertex_remap);
+    }
+
+    vertex_remap = NULL;
+    memset(face_remap, 0xcc, sizeof(face_remap));
+    hr = mesh->lpVtbl->OptimizeInplace(mesh, D3DXMESHOPT_VERTEXCACHE, adjacency, NULL,
+            face_remap, &vertex_remap);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    if (SUCCEEDED(hr))
+    {
+        check_vertex_cache_mesh(mesh, orig_vertices, orig_indices, orig_attribs,
+                num_attribs, face_remap, vertex_remap);
+        if (vertex_remap)
+            ID3DXBuffer_Release(vertex_remap);
+    }
+
+    mesh->lpVtbl->Release(mesh);
+    free_test_context(test_context);
+}
+
 static HRESULT clear_normals(ID3DXMesh *mesh)
 {
     HRESULT hr;
@@ -11474,12 +11769,14 @@ START_TEST(mesh)
     D3DXGenerateAdjacencyTest();
     test_update_semantics();
     test_create_skin_info();
+    test_update_skinned_mesh();
     test_convert_adjacency_to_point_reps();
     test_convert_point_reps_to_adjacency();
     test_weld_vertices();
     test_clone_mesh();
     test_valid_mesh();
     test_optimize_faces();
+    test_optimize_vertex_cache();
     test_compute_normals();
     test_D3DXFrameFind();
     test_load_skin_mesh_from_xof();
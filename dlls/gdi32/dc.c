@@ -52,7 +52,7 @@ struct graphics_driver
 };
 
 
-DC_ATTR *get_dc_attr( HDC hdc )
+static DC_ATTR *get_dc_attr_no_flush( HDC hdc )
 {
     DWORD type = gdi_handle_type( hdc );
     DC_ATTR *dc_attr;
@@ -64,6 +64,75 @@ DC_ATTR *get_dc_attr( HDC hdc )
     return dc_attr->disabled ? NULL : dc_attr;
 }
 
+DC_ATTR *get_dc_attr( HDC hdc )
+{
+    struct dc_batch *batch = NtUserGetThreadInfo()->gdi_batch;
+
+    /* batched commands need to be executed before any other GDI call */
+    if (batch && batch->count) NtGdiFlush();
+    return get_dc_attr_no_flush( hdc );
+}
+
+static DWORD batch_fls_index = FLS_OUT_OF_INDEXES;
+static INIT_ONCE batch_init_once = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI free_thread_batch( void *ptr )
+{
+    struct ntuser_thread_info *thread_info = NtUserGetThreadInfo();
+    struct dc_batch *batch = ptr;
+
+    if (!batch) return;
+    if (batch->count) NtGdiFlush();
+    if (thread_info->gdi_batch == batch) thread_info->gdi_batch = NULL;
+    HeapFree( GetProcessHeap(), 0, batch );
+}
+
+static BOOL WINAPI init_batch_fls( INIT_ONCE *once, void *param, void **context )
+{
+    batch_fls_index = FlsAlloc( free_thread_batch );
+    return TRUE;
+}
+
+static struct dc_batch *get_thread_batch(void)
+{
+    struct ntuser_thread_info *thread_info = NtUserGetThreadInfo();
+    struct dc_batch *batch;
+
+    if ((batch = thread_info->gdi_batch)) return batch;
+    InitOnceExecuteOnce( &batch_init_once, init_batch_fls, NULL, NULL );
+    if (batch_fls_index == FLS_OUT_OF_INDEXES) return NULL;
+    if (!(batch = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*batch) ))) return NULL;
+    /* the FLS callback frees the buffer on thread exit */
+    FlsSetValue( batch_fls_index, batch );
+    thread_info->gdi_batch = batch;
+    return batch;
+}
+
+/* record a drawing command instead of executing it, returns FALSE if it needs to be executed right away */
+static BOOL add_batch_command( HDC hdc, DC_ATTR *dc_attr, UINT type, const INT *args, UINT count )
+{
+    struct ntuser_thread_info *thread_info = NtUserGetThreadInfo();
+    UINT limit = min( thread_info->batch_limit, DC_BATCH_SIZE );
+    struct dc_batch_entry *entry;
+    struct dc_batch *batch;
+
+    if (limit <= 1 || dc_attr->emf || !(batch = get_thread_batch()))
+    {
+        /* keep the commands in order with the ones already batched */
+        if ((batch = thread_info->gdi_batch) && batch->count) NtGdiFlush();
+        return FALSE;
+    }
+
+    /* commands are only batched for one DC at a time */
+    if (batch->count && (batch->hdc != hdc || batch->count >= limit)) NtGdiFlush();
+
+    batch->hdc = hdc;
+    entry = &batch->entries[batch->count++];
+    entry->type = type;
+    memcpy( entry->args, args, count * sizeof(*args) );
+    return TRUE;
+}
+
 static BOOL is_display_device( const WCHAR *name )
 {
     const WCHAR *p = name;
@@ -1242,13 +1311,15 @@ BOOL WINAPI SetPixelV( HDC hdc, INT x, INT y, COLORREF color )
  */
 BOOL WINAPI LineTo( HDC hdc, INT x, INT y )
 {
+    INT args[] = { x, y };
     DC_ATTR *dc_attr;
 
     TRACE( "%p, (%d, %d)\n", hdc, x, y );
 
     if (is_meta_dc( hdc )) return METADC_LineTo( hdc, x, y );
-    if (!(dc_attr = get_dc_attr( hdc ))) return FALSE;
+    if (!(dc_attr = get_dc_attr_no_flush( hdc ))) return FALSE;
     if (dc_attr->emf && !EMFDC_LineTo( dc_attr, x, y )) return FALSE;
+    if (add_batch_command( hdc, dc_attr, NTGDI_BATCH_LINETO, args, ARRAY_SIZE(args) )) return TRUE;
     return NtGdiLineTo( hdc, x, y );
 }
 
@@ -1394,13 +1465,15 @@ BOOL WINAPI Ellipse( HDC hdc, INT left, INT top, INT right, INT bottom )
  */
 BOOL WINAPI Rectangle( HDC hdc, INT left, INT top, INT right, INT bottom )
 {
+    INT args[] = { left, top, right, bottom };
     DC_ATTR *dc_attr;
 
     TRACE( "%p, (%d, %d)-(%d, %d)\n", hdc, left, top, right, bottom );
 
     if (is_meta_dc( hdc )) return METADC_Rectangle( hdc, left, top, right, bottom );
-    if (!(dc_attr = get_dc_attr( hdc ))) return FALSE;
+    if (!(dc_attr = get_dc_attr_no_flush( hdc ))) return FALSE;
     if (dc_attr->emf && !EMFDC_Rectangle( dc_attr, left, top, right, bottom )) return FALSE;
+    if (add_batch_command( hdc, dc_attr, NTGDI_BATCH_RECTANGLE, args, ARRAY_SIZE(args) )) return TRUE;
     return NtGdiRectangle( hdc, left, top, right, bottom );
 }
 
@@ -1666,12 +1739,14 @@ BOOL WINAPI SetTextJustification( HDC hdc, INT extra, INT breaks )
  */
 BOOL WINAPI PatBlt( HDC hdc, INT left, INT top, INT width, INT height, DWORD rop )
 {
+    INT args[] = { left, top, width, height, rop };
     DC_ATTR *dc_attr;
 
     if (is_meta_dc( hdc )) return METADC_PatBlt( hdc, left, top, width, height, rop );
-    if (!(dc_attr = get_dc_attr( hdc ))) return FALSE;
+    if (!(dc_attr = get_dc_attr_no_flush( hdc ))) return FALSE;
     if (dc_attr->emf && !EMFDC_PatBlt( dc_attr, left, top, width, height, rop ))
         return FALSE;
+    if (add_batch_command( hdc, dc_attr, NTGDI_BATCH_PATBLT, args, ARRAY_SIZE(args) )) return TRUE;
     return NtGdiPatBlt( hdc, left, top, width, height, rop );
 }
 
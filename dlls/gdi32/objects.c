@@ -993,7 +993,8 @@ DWORD WINAPI GdiInitializeLanguagePack( DWORD arg )
  */
 DWORD WINAPI GdiGetBatchLimit(void)
 {
-    return 1;  /* FIXME */
+    DWORD limit = NtUserGetThreadInfo()->batch_limit;
+    return limit ? limit : 1;
 }
 
 /***********************************************************************
@@ -1001,7 +1002,13 @@ DWORD WINAPI GdiGetBatchLimit(void)
  */
 DWORD WINAPI GdiSetBatchLimit( DWORD limit )
 {
-    return 1; /* FIXME */
+    DWORD prev = GdiGetBatchLimit();
+
+    TRACE( "%lu\n", limit );
+
+    NtGdiFlush();
+    NtUserGetThreadInfo()->batch_limit = limit;
+    return prev;
 }
 
 /* Solid colors to enumerate */
@@ -559,6 +559,66 @@ static void test_CreatePolyPolygonRgn(void)
     DeleteObject(region);
 }
 
+static void test_large_region(void)
+{
+    HRGN region, tmp;
+    RECT rect;
+    DWORD size;
+    RGNDATA *data;
+    int ret, x, y;
+
+    /* checkerboard of 10x10 cells, nothing can be coalesced */
+    region = CreateRectRgn(0, 0, 0, 0);
+    tmp = CreateRectRgn(0, 0, 0, 0);
+    for (y = 0; y < 100; y++)
+    {
+        for (x = y % 2; x < 100; x += 2)
+        {
+            SetRectRgn(tmp, x * 10, y * 10, x * 10 + 10, y * 10 + 10);
+            CombineRgn(region, region, tmp, RGN_OR);
+        }
+    }
+
+    size = GetRegionData(region, 0, NULL);
+    data = HeapAlloc(GetProcessHeap(), 0, size);
+    ret = GetRegionData(region, size, data);
+    ok(ret == size, "GetRegionData returned %d\n", ret);
+    ok(data->rdh.nCount == 5000, "got %lu rects\n", data->rdh.nCount);
+    HeapFree(GetProcessHeap(), 0, data);
+
+    ok(PtInRegion(region, 5, 5), "expected point in region\n");
+    ok(!PtInRegion(region, 15, 5), "expected point outside region\n");
+    ok(PtInRegion(region, 15, 15), "expected point in region\n");
+    ok(!PtInRegion(region, 995, 985), "expected point outside region\n");
+    ok(PtInRegion(region, 995, 995), "expected point in region\n");
+
+    SetRect(&rect, 11, 1, 19, 9);
+    ok(!RectInRegion(region, &rect), "expected rect outside region\n");
+    SetRect(&rect, 11, 1, 19, 12);
+    ok(RectInRegion(region, &rect), "expected rect in region\n");
+    SetRect(&rect, 1, 11, 9, 19);
+    ok(!RectInRegion(region, &rect), "expected rect outside region\n");
+    SetRect(&rect, 1, 11, 9, 29);
+    ok(RectInRegion(region, &rect), "expected rect in region\n");
+
+    SetRectRgn(tmp, 15, 15, 35, 25);
+    ret = CombineRgn(tmp, region, tmp, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    ret = GetRgnBox(tmp, &rect);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    ok(rect.left == 15 && rect.top == 15 && rect.right == 35 && rect.bottom == 25,
+       "got %s\n", wine_dbgstr_rect(&rect));
+    ret = GetRegionData(tmp, 0, NULL);
+    ok(ret == sizeof(RGNDATAHEADER) + 3 * sizeof(RECT), "got size %d\n", ret);
+
+    SetRectRgn(tmp, 2000, 2000, 2010, 2010);
+    ret = CombineRgn(tmp, region, tmp, RGN_AND);
+    ok(ret == NULLREGION, "got %d\n", ret);
+
+    DeleteObject(tmp);
+    DeleteObject(region);
+}
+
 START_TEST(clipping)
 {
     test_GetRandomRgn();
@@ -567,4 +627,5 @@ START_TEST(clipping)
     test_memory_dc_clipping();
     test_window_dc_clipping();
     test_CreatePolyPolygonRgn();
+    test_large_region();
 }
@@ -1690,6 +1690,69 @@ static void test_clip_box(void)
     DeleteObject(bitmap);
 }
 
+static void test_batch_limit(void)
+{
+    BITMAPINFO bmi = {{sizeof(bmi.bmiHeader), 16, -16, 1, 32, BI_RGB}};
+    DWORD *bits, limit, prev;
+    HBITMAP bitmap;
+    HBRUSH brush;
+    COLORREF color;
+    POINT pt;
+    BOOL ret;
+    HDC hdc;
+
+    prev = GdiSetBatchLimit(10);
+    ok(prev, "GdiSetBatchLimit failed\n");
+    limit = GdiGetBatchLimit();
+    ok(limit == 10, "got limit %lu\n", limit);
+
+    hdc = CreateCompatibleDC(0);
+    bitmap = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, (void **)&bits, NULL, 0);
+    ok(!!bitmap, "CreateDIBSection failed\n");
+    SelectObject(hdc, bitmap);
+
+    /* batched commands are executed before the DC is queried */
+    ret = PatBlt(hdc, 0, 0, 16, 16, WHITENESS);
+    ok(ret, "PatBlt failed\n");
+    color = GetPixel(hdc, 8, 8);
+    ok(color == RGB(255, 255, 255), "got color %06lx\n", color);
+
+    /* objects selected after a batched command don't affect it */
+    brush = CreateSolidBrush(RGB(255, 0, 0));
+    SelectObject(hdc, brush);
+    ret = PatBlt(hdc, 0, 0, 8, 16, PATCOPY);
+    ok(ret, "PatBlt failed\n");
+    SelectObject(hdc, GetStockObject(BLACK_BRUSH));
+    ret = PatBlt(hdc, 8, 0, 8, 16, PATCOPY);
+    ok(ret, "PatBlt failed\n");
+    GdiFlush();
+    ok(bits[0] == 0xff0000, "got %08lx\n", bits[0]);
+    ok(bits[15] == 0, "got %08lx\n", bits[15]);
+
+    SelectObject(hdc, GetStockObject(WHITE_BRUSH));
+    SelectObject(hdc, GetStockObject(NULL_PEN));
+    ret = Rectangle(hdc, 0, 0, 5, 5);
+    ok(ret, "Rectangle failed\n");
+    GdiFlush();
+    ok(bits[16 + 1] == 0xffffff, "got %08lx\n", bits[16 + 1]);
+
+    /* the current position is updated before it is retrieved */
+    MoveToEx(hdc, 0, 0, NULL);
+    ret = LineTo(hdc, 5, 7);
+    ok(ret, "LineTo failed\n");
+    GetCurrentPositionEx(hdc, &pt);
+    ok(pt.x == 5 && pt.y == 7, "got (%ld,%ld)\n", pt.x, pt.y);
+
+    DeleteDC(hdc);
+    DeleteObject(bitmap);
+    DeleteObject(brush);
+
+    limit = GdiSetBatchLimit(prev);
+    ok(limit == 10, "got limit %lu\n", limit);
+    limit = GdiGetBatchLimit();
+    ok(limit == prev, "got limit %lu\n", limit);
+}
+
 static void test_SetPixel(void)
 {
     COLORREF c;
@@ -1715,5 +1778,6 @@ START_TEST(dc)
     test_printer_dc();
     test_pscript_printer_dc();
     test_clip_box();
+    test_batch_limit();
     test_SetPixel();
 }
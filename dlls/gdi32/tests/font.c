@@ -3266,6 +3266,52 @@ static void test_EnumFontFamiliesEx_default_charset(void)
     return;
 }
 
+static INT CALLBACK find_family_proc(const LOGFONTA *lf, const TEXTMETRICA *ntm, DWORD type, LPARAM lParam)
+{
+    return !!strcmp(lf->lfFaceName, (const char *)lParam);
+}
+
+static BOOL is_family_enumerated(const char *name)
+{
+    HDC hdc = GetDC(0);
+    LOGFONTA lf;
+    BOOL ret;
+
+    memset(&lf, 0, sizeof(lf));
+    lf.lfCharSet = DEFAULT_CHARSET;
+    ret = !EnumFontFamiliesExA(hdc, &lf, find_family_proc, (LPARAM)name, 0);
+    ReleaseDC(0, hdc);
+    return ret;
+}
+
+static void test_EnumFontFamiliesEx_font_list_changes(void)
+{
+    char ttf_name[MAX_PATH];
+    BOOL ret;
+
+    if (!write_ttf_file("wine_test.ttf", ttf_name))
+    {
+        skip("Failed to create ttf file for testing\n");
+        return;
+    }
+
+    /* enumerate twice, the second enumeration may come from a cache */
+    ok(!is_family_enumerated("wine_test"), "font wine_test should not be enumerated\n");
+    ok(!is_family_enumerated("wine_test"), "font wine_test should not be enumerated\n");
+
+    ret = AddFontResourceExA(ttf_name, 0, 0);
+    ok(ret, "AddFontResourceEx() error %ld\n", GetLastError());
+    ok(is_family_enumerated("wine_test"), "font wine_test should be enumerated\n");
+    ok(is_family_enumerated("wine_test"), "font wine_test should be enumerated\n");
+
+    ret = RemoveFontResourceExA(ttf_name, 0, 0);
+    ok(ret, "RemoveFontResourceEx() error %ld\n", GetLastError());
+    ok(!is_family_enumerated("wine_test"), "font wine_test should not be enumerated\n");
+
+    ret = DeleteFileA(ttf_name);
+    ok(ret, "DeleteFile() error %ld\n", GetLastError());
+}
+
 static void test_negative_width(HDC hdc, const LOGFONTA *lf)
 {
     HFONT hfont, hfont_prev;
@@ -7802,6 +7848,7 @@ START_TEST(font)
     else
         skip("Arial Black or Symbol/Wingdings is not installed\n");
     test_EnumFontFamiliesEx_default_charset();
+    test_EnumFontFamiliesEx_font_list_changes();
     test_GetTextMetrics();
     test_RealizationInfo();
     test_GetTextFace();
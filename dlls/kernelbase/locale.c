@@ -330,6 +330,7 @@ static struct
     DWORD            version;    /* NLS version */
     DWORD            guid_count; /* number of sort GUIDs */
     struct sortguid *guids;      /* table of sort GUIDs */
+    unsigned int     ascii_ce[0x80]; /* collation elements for the ASCII range */
 } sort;
 
 static CRITICAL_SECTION locale_section;
@@ -384,6 +385,7 @@ static void init_sortkeys( DWORD *ptr )
 {
     WORD *ctype;
     DWORD *table;
+    unsigned int i;
 
     sort.keys = (DWORD *)((char *)ptr + ptr[0]);
     sort.casemap = (USHORT *)((char *)ptr + ptr[1]);
@@ -396,6 +398,9 @@ static void init_sortkeys( DWORD *ptr )
     sort.version = table[0];
     sort.guid_count = table[1];
     sort.guids = (struct sortguid *)(table + 2);
+
+    for (i = 0; i < ARRAY_SIZE(sort.ascii_ce); i++)
+        sort.ascii_ce[i] = collation_table[collation_table[collation_table[0] + (i >> 4)] + (i & 0xf)];
 }
 
 
@@ -1882,6 +1887,7 @@ static const WCHAR *get_decomposition( WCHAR ch, unsigned int *ret_len )
     unsigned int i, pos, end, len, hash;
 
     *ret_len = 1;
+    if (ch < 0x80) return NULL;  /* no decompositions in the ASCII range */
     hash = ch % norm_info->decomp_size;
     pos = hash_table[hash];
     if (pos >> 13)
@@ -3041,6 +3047,13 @@ static int wcstombs_codepage( const CPTABLEINFO *info, DWORD flags, const WCHAR
 }
 
 
+static inline unsigned int get_collation_element( WCHAR ch )
+{
+    if (ch < ARRAY_SIZE(sort.ascii_ce)) return sort.ascii_ce[ch];
+    return collation_table[collation_table[collation_table[ch >> 8] + ((ch >> 4) & 0x0f)] + (ch & 0xf)];
+}
+
+
 static int get_sortkey( DWORD flags, const WCHAR *src, int srclen, char *dst, int dstlen )
 {
     WCHAR dummy[4]; /* no decomposition is larger than 4 chars */
@@ -3067,7 +3080,7 @@ static int get_sortkey( DWORD flags, const WCHAR *src, int srclen, char *dst, in
 
                 if (flags & NORM_IGNORECASE) wch = casemap( nls_info.LowerCaseTable, wch );
 
-                ce = collation_table[collation_table[collation_table[wch >> 8] + ((wch >> 4) & 0x0f)] + (wch & 0xf)];
+                ce = get_collation_element( wch );
                 if (ce != (unsigned int)-1)
                 {
                     if (ce >> 16) key_len[0] += 2;
@@ -3121,7 +3134,7 @@ static int get_sortkey( DWORD flags, const WCHAR *src, int srclen, char *dst, in
 
                 if (flags & NORM_IGNORECASE) wch = casemap( nls_info.LowerCaseTable, wch );
 
-                ce = collation_table[collation_table[collation_table[wch >> 8] + ((wch >> 4) & 0x0f)] + (wch & 0xf)];
+                ce = get_collation_element( wch );
                 if (ce != (unsigned int)-1)
                 {
                     WCHAR key;
@@ -3380,7 +3393,7 @@ static unsigned int get_weight( WCHAR ch, enum weight type )
 {
     unsigned int ret;
 
-    ret = collation_table[collation_table[collation_table[ch >> 8] + ((ch >> 4) & 0x0f)] + (ch & 0xf)];
+    ret = get_collation_element( ch );
     if (ret == ~0u) return ch;
 
     switch (type)
@@ -3405,12 +3418,39 @@ static void inc_str_pos( const WCHAR **str, int *len, unsigned int *dpos, unsign
 }
 
 
+/* check whether an ASCII char is always compared one-to-one at the given weight level,
+ * i.e. it is neither ignored nor subject to the hyphen and apostrophe rules */
+static inline BOOL is_plain_ascii_char( int flags, WCHAR ch, enum weight type )
+{
+    if (ch >= 0x80) return FALSE;
+    if (!get_weight( ch, type )) return FALSE;
+    if (type == UNICODE_WEIGHT && !(flags & SORT_STRINGSORT) && (ch == '-' || ch == '\'')) return FALSE;
+    if ((flags & NORM_IGNORESYMBOLS) && (get_char_type( CT_CTYPE1, ch ) & (C1_PUNCT | C1_SPACE))) return FALSE;
+    return TRUE;
+}
+
+
 static int compare_weights(int flags, const WCHAR *str1, int len1,
                            const WCHAR *str2, int len2, enum weight type )
 {
     unsigned int ce1, ce2, dpos1 = 0, dpos2 = 0, dlen1 = 0, dlen2 = 0;
     const WCHAR *dstr1 = NULL, *dstr2 = NULL;
 
+    /* fast path for the common prefix of plain ASCII chars; these don't
+     * need the decomposition and ignore rules of the generic loop below */
+    while (len1 > 0 && len2 > 0)
+    {
+        if (!is_plain_ascii_char( flags, *str1, type )) break;
+        if (*str2 != *str1 && !is_plain_ascii_char( flags, *str2, type )) break;
+        ce1 = get_weight( *str1, type );
+        ce2 = get_weight( *str2, type );
+        if (ce1 - ce2) return ce1 - ce2;
+        str1++;
+        str2++;
+        len1--;
+        len2--;
+    }
+
     while (len1 > 0 && len2 > 0)
     {
         if (!dlen1 && !(dstr1 = get_decomposition( *str1, &dlen1 ))) dstr1 = str1;
@@ -942,9 +942,10 @@ static void WINAPI user_apc_proc(ULONG_PTR arg)
 
 static void test_set_io_completion(void)
 {
+    static FILE_IO_COMPLETION_INFORMATION many[150];
     FILE_IO_COMPLETION_INFORMATION info[2] = {{0}};
     LARGE_INTEGER timeout = {{0}};
-    unsigned int apc_count;
+    unsigned int apc_count, i;
     IO_STATUS_BLOCK iosb;
     ULONG_PTR key, value;
     NTSTATUS res;
@@ -1049,6 +1050,34 @@ static void test_set_io_completion(void)
         info[0].IoStatusBlock.Information );
     ok( U(info[0].IoStatusBlock).Status == 56, "wrong status %#lx\n", U(info[0].IoStatusBlock).Status);
 
+    for (i = 0; i < 140; i++)
+    {
+        res = pNtSetIoCompletion( h, i, i * 2, i * 3, size );
+        ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %#lx\n", res );
+    }
+
+    count = 0xdeadbeef;
+    res = pNtRemoveIoCompletionEx( h, many, 100, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %#lx\n", res );
+    ok( count == 100, "wrong count %lu\n", count );
+    count = get_pending_msgs(h);
+    ok( count == 40, "Unexpected msg count: %ld\n", count );
+
+    count = 0xdeadbeef;
+    res = pNtRemoveIoCompletionEx( h, many + 100, ARRAY_SIZE(many) - 100, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %#lx\n", res );
+    ok( count == 40, "wrong count %lu\n", count );
+    count = get_pending_msgs(h);
+    ok( !count, "Unexpected msg count: %ld\n", count );
+
+    for (i = 0; i < 140; i++)
+    {
+        if (many[i].CompletionKey != i || many[i].CompletionValue != i * 2
+                || U(many[i].IoStatusBlock).Status != i * 3 || many[i].IoStatusBlock.Information != size)
+            break;
+    }
+    ok( i == 140, "wrong completion %u, key %#Ix\n", i, many[i].CompletionKey );
+
     apc_count = 0;
     QueueUserAPC( user_apc_proc, GetCurrentThread(), (ULONG_PTR)&apc_count );
 
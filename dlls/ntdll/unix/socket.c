@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <unistd.h>
 #ifdef HAVE_IFADDRS_H
 # include <ifaddrs.h>
@@ -41,6 +42,9 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef linux
+# include <sys/sendfile.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -89,6 +93,10 @@
 #define IP_UNICAST_IF 50
 #endif
 
+#ifndef MSG_MORE
+#define MSG_MORE 0
+#endif
+
 WINE_DEFAULT_DEBUG_CHANNEL(winsock);
 
 #define u64_to_user_ptr(u) ((void *)(uintptr_t)(u))
@@ -148,6 +156,22 @@ struct async_transmit_ioctl
     unsigned int head_len;
     unsigned int tail_len;
     LARGE_INTEGER offset;
+    BOOL no_sendfile;           /* sendfile() is not supported for this file */
+    BOOL corked;                /* data sent with MSG_MORE may still be queued */
+};
+
+struct async_transmit_packets_ioctl
+{
+    struct async_fileio io;
+    char *buffer;               /* bounce buffer, only used if sendfile() is not supported */
+    unsigned int buffer_size;
+    unsigned int count;
+    unsigned int cursor;        /* index of the element currently being sent */
+    unsigned int elem_cursor;   /* amount of the current element already sent */
+    ULONG_PTR sent;             /* total amount of data sent */
+    BOOL no_sendfile;
+    BOOL corked;                /* data sent with MSG_MORE may still be queued */
+    struct afd_transmit_packets_element elements[1];
 };
 
 static NTSTATUS sock_errno_to_status( int err )
@@ -954,18 +978,56 @@ static ssize_t do_send( int fd, const void *buffer, size_t len, int flags )
     return ret;
 }
 
+/* Send file data straight from the page cache, without copying it through
+ * user space. Returns -1 with errno set to ENOSYS if not supported. */
+static ssize_t do_sendfile( int sock_fd, int file_fd, LARGE_INTEGER *offset, size_t len )
+{
+#ifdef linux
+    off_t off = offset ? offset->QuadPart : 0;
+    ssize_t ret;
+
+    while ((ret = sendfile( sock_fd, file_fd, offset ? &off : NULL, min( len, 0x7ffff000 ) )) < 0
+            && errno == EINTR);
+    if (ret < 0 && errno != EWOULDBLOCK) WARN( "sendfile: %s\n", strerror( errno ) );
+    if (offset) offset->QuadPart = off;
+    return ret;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+static BOOL sendfile_unsupported( int err )
+{
+    return err == ENOSYS || err == EINVAL || err == EOPNOTSUPP;
+}
+
+/* Push out data queued with MSG_MORE, in case nothing was sent after it
+ * (e.g. the following file was empty or already at end of file). */
+static void uncork_socket( int sock_fd )
+{
+#ifdef TCP_CORK
+    int value = 0;
+
+    if (setsockopt( sock_fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value) ))
+        WARN( "failed to uncork socket: %s\n", strerror( errno ) );
+#endif
+}
+
 static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_ioctl *async )
 {
     ssize_t ret;
 
     while (async->head_cursor < async->head_len)
     {
+        int flags = async->file || async->tail_len ? MSG_MORE : 0;
+
         TRACE( "sending %u bytes of header data\n", async->head_len - async->head_cursor );
-        ret = do_send( sock_fd, async->head + async->head_cursor,
-                       async->head_len - async->head_cursor, 0 );
+        ret = do_send( sock_fd, async->head + async->head_cursor, async->head_len - async->head_cursor, flags );
         if (ret < 0) return sock_errno_to_status( errno );
         TRACE( "send returned %zd\n", ret );
         async->head_cursor += ret;
+        async->corked = !!flags;
     }
 
     while (async->buffer_cursor < async->read_len)
@@ -977,12 +1039,42 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         TRACE( "send returned %zd\n", ret );
         async->buffer_cursor += ret;
         async->file_cursor += ret;
+        async->corked = FALSE;
+    }
+
+    while (async->file && async->buffer_cursor == async->read_len && !async->no_sendfile)
+    {
+        size_t len = async->file_len ? async->file_len - async->file_cursor : ~(size_t)0;
+        LARGE_INTEGER *offset = NULL;
+
+        if (!len)
+        {
+            async->file = NULL;
+            break;
+        }
+        if (async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            offset = &async->offset;
+
+        TRACE( "sending up to %zu bytes of file data with sendfile\n", len );
+        if ((ret = do_sendfile( sock_fd, file_fd, offset, len )) < 0)
+        {
+            if (!sendfile_unsupported( errno )) return sock_errno_to_status( errno );
+            TRACE( "sendfile not supported, falling back to read/send\n" );
+            async->no_sendfile = TRUE;
+            break;
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+        if (!ret) async->file = NULL; /* end of file */
+        async->file_cursor += ret;
     }
 
     if (async->file && async->buffer_cursor == async->read_len)
     {
         unsigned int read_size = async->buffer_size;
 
+        if (!async->buffer && !(async->buffer = malloc( async->buffer_size )))
+            return STATUS_NO_MEMORY;
+
         if (async->file_len)
             read_size = min( read_size, async->file_len - async->file_cursor );
 
@@ -1015,8 +1107,14 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         if (ret < 0) return sock_errno_to_status( errno );
         TRACE( "send returned %zd\n", ret );
         async->tail_cursor += ret;
+        async->corked = FALSE;
     }
 
+    if (async->corked)
+    {
+        uncork_socket( sock_fd );
+        async->corked = FALSE;
+    }
     return STATUS_SUCCESS;
 }
 
@@ -1048,6 +1146,7 @@ static BOOL async_transmit_proc( void *user, ULONG_PTR *info, NTSTATUS *status )
             return FALSE;
     }
     *info = async->head_cursor + async->file_cursor + async->tail_cursor;
+    free( async->buffer );
     release_fileio( &async->io );
     return TRUE;
 }
@@ -1070,6 +1169,9 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     if (getpeername( fd, &addr.addr, &addr_len ) != 0)
         return STATUS_INVALID_CONNECTION;
 
+    if (params->flags & (TF_DISCONNECT | TF_REUSE_SOCKET))
+        FIXME( "unsupported flags %#x\n", params->flags & (TF_DISCONNECT | TF_REUSE_SOCKET) );
+
     if (params->file)
     {
         if ((status = server_get_unix_fd( ULongToHandle( params->file ), 0, &file_fd, &file_needs_close, &file_type, NULL )))
@@ -1087,12 +1189,11 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
         return STATUS_NO_MEMORY;
 
     async->file = ULongToHandle( params->file );
+    /* The buffer is only needed if we can't use sendfile(), so allocate it on demand. */
+    async->buffer = NULL;
     async->buffer_size = params->buffer_size ? params->buffer_size : 65536;
-    if (!(async->buffer = malloc( async->buffer_size )))
-    {
-        release_fileio( &async->io );
-        return STATUS_NO_MEMORY;
-    }
+    async->no_sendfile = FALSE;
+    async->corked = FALSE;
     async->read_len = 0;
     async->head_cursor = 0;
     async->file_cursor = 0;
@@ -1129,6 +1230,244 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
         information = async->head_cursor + async->file_cursor + async->tail_cursor;
         if (!NT_ERROR(status) || wait_handle)
             set_async_iosb( io, status, information );
+        free( async->buffer );
+        release_fileio( &async->io );
+    }
+    else information = 0;
+
+    if (alerted)
+    {
+        set_async_direct_result( &wait_handle, status, information, TRUE );
+        if (!(options & (FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT)))
+        {
+            /* Pretend we always do async I/O.  The client can always retrieve
+             * the actual I/O status via the IO_STATUS_BLOCK.
+             */
+            status = STATUS_PENDING;
+        }
+    }
+    if (wait_handle) status = wait_async( wait_handle, options & FILE_SYNCHRONOUS_IO_ALERT );
+    return status;
+}
+
+static NTSTATUS transmit_packet_file( int sock_fd, struct async_transmit_packets_ioctl *async,
+                                      struct afd_transmit_packets_element *elem )
+{
+    int file_fd, needs_close;
+    enum server_fd_type type;
+    LARGE_INTEGER offset;
+    NTSTATUS status;
+    ssize_t ret;
+
+    if ((status = server_get_unix_fd( ULongToHandle( elem->file ), 0, &file_fd, &needs_close, &type, NULL )))
+        return status;
+    if (type != FD_TYPE_FILE)
+    {
+        status = STATUS_INVALID_PARAMETER;
+        goto done;
+    }
+    status = STATUS_SUCCESS;
+
+    /* An offset of -1 means the current file position. Resolve it once, so
+     * that we can resume at the right place if the socket buffer fills up. */
+    if (elem->offset.QuadPart == -1 && (elem->offset.QuadPart = lseek( file_fd, 0, SEEK_CUR )) == -1)
+    {
+        status = errno_to_status( errno );
+        goto done;
+    }
+
+    for (;;)
+    {
+        size_t len = elem->len ? elem->len - async->elem_cursor : ~(size_t)0;
+
+        if (!len) break;
+        offset.QuadPart = elem->offset.QuadPart + async->elem_cursor;
+
+        if (!async->no_sendfile)
+        {
+            if ((ret = do_sendfile( sock_fd, file_fd, &offset, len )) < 0)
+            {
+                if (!sendfile_unsupported( errno ))
+                {
+                    status = sock_errno_to_status( errno );
+                    break;
+                }
+                TRACE( "sendfile not supported, falling back to read/send\n" );
+                async->no_sendfile = TRUE;
+                continue;
+            }
+        }
+        else
+        {
+            ssize_t read_len;
+
+            if (!async->buffer && !(async->buffer = malloc( async->buffer_size )))
+            {
+                status = STATUS_NO_MEMORY;
+                break;
+            }
+            while ((read_len = pread( file_fd, async->buffer, min( len, async->buffer_size ),
+                                      offset.QuadPart )) < 0 && errno == EINTR);
+            if (read_len < 0)
+            {
+                status = errno_to_status( errno );
+                break;
+            }
+            ret = read_len ? do_send( sock_fd, async->buffer, read_len, 0 ) : 0;
+            if (ret < 0)
+            {
+                status = sock_errno_to_status( errno );
+                break;
+            }
+            if (ret) async->corked = FALSE;
+        }
+        TRACE( "sent %zd bytes of file data\n", ret );
+
+        if (!ret) break; /* end of file */
+        async->elem_cursor += ret;
+        async->sent += ret;
+    }
+
+done:
+    if (needs_close) close( file_fd );
+    return status;
+}
+
+static NTSTATUS try_transmit_packets( int sock_fd, struct async_transmit_packets_ioctl *async )
+{
+    NTSTATUS status;
+    ssize_t ret;
+
+    for (; async->cursor < async->count; ++async->cursor, async->elem_cursor = 0)
+    {
+        struct afd_transmit_packets_element *elem = &async->elements[async->cursor];
+
+        if (elem->flags & TP_ELEMENT_FILE)
+        {
+            if ((status = transmit_packet_file( sock_fd, async, elem )))
+                return status;
+            continue;
+        }
+
+        while (async->elem_cursor < elem->len)
+        {
+            int flags = 0;
+
+            /* Let the kernel coalesce small elements into full segments. */
+            if (async->cursor + 1 < async->count && !(elem->flags & TP_ELEMENT_EOP))
+                flags = MSG_MORE;
+
+            TRACE( "sending %u bytes of element %u\n", elem->len - async->elem_cursor, async->cursor );
+            ret = do_send( sock_fd, (const char *)u64_to_user_ptr( elem->buffer_ptr ) + async->elem_cursor,
+                           elem->len - async->elem_cursor, flags );
+            if (ret < 0) return sock_errno_to_status( errno );
+            TRACE( "send returned %zd\n", ret );
+            async->elem_cursor += ret;
+            async->sent += ret;
+            async->corked = !!flags;
+        }
+    }
+
+    if (async->corked)
+    {
+        uncork_socket( sock_fd );
+        async->corked = FALSE;
+    }
+    return STATUS_SUCCESS;
+}
+
+static BOOL async_transmit_packets_proc( void *user, ULONG_PTR *info, NTSTATUS *status )
+{
+    struct async_transmit_packets_ioctl *async = user;
+    int sock_fd, needs_close;
+
+    TRACE( "%#x\n", *status );
+
+    if (*status == STATUS_ALERTED)
+    {
+        if ((*status = server_get_unix_fd( async->io.handle, 0, &sock_fd, &needs_close, NULL, NULL )))
+            return TRUE;
+
+        *status = try_transmit_packets( sock_fd, async );
+        TRACE( "got status %#x\n", *status );
+
+        if (needs_close) close( sock_fd );
+
+        if (*status == STATUS_DEVICE_NOT_READY)
+            return FALSE;
+    }
+    *info = async->sent;
+    free( async->buffer );
+    release_fileio( &async->io );
+    return TRUE;
+}
+
+static NTSTATUS sock_transmit_packets( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                                       client_ptr_t io, int fd, const struct afd_transmit_packets_params *params,
+                                       const struct afd_transmit_packets_element *elements )
+{
+    struct async_transmit_packets_ioctl *async;
+    union unix_sockaddr addr;
+    socklen_t addr_len;
+    HANDLE wait_handle;
+    NTSTATUS status;
+    ULONG_PTR information;
+    ULONG options;
+    unsigned int i;
+    BOOL alerted;
+
+    addr_len = sizeof(addr);
+    if (getpeername( fd, &addr.addr, &addr_len ) != 0)
+        return STATUS_INVALID_CONNECTION;
+
+    for (i = 0; i < params->count; ++i)
+    {
+        if (!(elements[i].flags & TP_ELEMENT_FILE) == !(elements[i].flags & TP_ELEMENT_MEMORY))
+            return STATUS_INVALID_PARAMETER;
+    }
+
+    if (params->flags & (TP_DISCONNECT | TP_REUSE_SOCKET))
+        FIXME( "unsupported flags %#x\n", params->flags & (TP_DISCONNECT | TP_REUSE_SOCKET) );
+
+    if (!(async = (struct async_transmit_packets_ioctl *)alloc_fileio(
+            offsetof( struct async_transmit_packets_ioctl, elements[params->count] ),
+            async_transmit_packets_proc, handle )))
+        return STATUS_NO_MEMORY;
+
+    async->buffer = NULL;
+    async->buffer_size = params->send_size ? params->send_size : 65536;
+    async->count = params->count;
+    async->cursor = 0;
+    async->elem_cursor = 0;
+    async->sent = 0;
+    async->no_sendfile = FALSE;
+    async->corked = FALSE;
+    memcpy( async->elements, elements, params->count * sizeof(*elements) );
+
+    SERVER_START_REQ( send_socket )
+    {
+        req->force_async = 1;
+        req->async  = server_async( handle, &async->io, event, apc, apc_user, io );
+        status = wine_server_call( req );
+        wait_handle = wine_server_ptr_handle( reply->wait );
+        options     = reply->options;
+    }
+    SERVER_END_REQ;
+
+    alerted = status == STATUS_ALERTED;
+    if (alerted)
+    {
+        status = try_transmit_packets( fd, async );
+        if (status == STATUS_DEVICE_NOT_READY)
+            status = STATUS_PENDING;
+    }
+
+    if (status != STATUS_PENDING)
+    {
+        information = async->sent;
+        if (!NT_ERROR(status) || wait_handle)
+            set_async_iosb( io, status, information );
+        free( async->buffer );
         release_fileio( &async->io );
     }
     else information = 0;
@@ -1157,6 +1496,192 @@ static void complete_async( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, vo
     if (apc_user) add_completion( handle, (ULONG_PTR)apc_user, status, information, FALSE );
 }
 
+/* Poll a single socket directly, mirroring poll_single_socket() in the
+ * server. Returns -1 if the socket is in a state that only the server can
+ * answer for, e.g. an unconnected or connecting stream socket, or one with
+ * a pending error or hangup. */
+static int poll_single_socket_fast( int fd, int mask )
+{
+    BOOL listening = FALSE, oobinline = FALSE;
+    union unix_sockaddr addr;
+    struct pollfd pollfd;
+    socklen_t len;
+    int type, value, flags = 0;
+
+    len = sizeof(type);
+    if (getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&type, &len )) return -1;
+
+    if (type == SOCK_STREAM)
+    {
+        len = sizeof(value);
+        if (getsockopt( fd, SOL_SOCKET, SO_ACCEPTCONN, (char *)&value, &len )) return -1;
+        listening = !!value;
+        len = sizeof(addr);
+        if (!listening && getpeername( fd, &addr.addr, &len )) return -1;
+    }
+    else if (type != SOCK_DGRAM)
+        return -1;
+
+    if (mask & AFD_POLL_OOB)
+    {
+        len = sizeof(value);
+        oobinline = !getsockopt( fd, SOL_SOCKET, SO_OOBINLINE, (char *)&value, &len ) && value;
+    }
+
+    pollfd.fd = fd;
+    pollfd.events = 0;
+    if (mask & (AFD_POLL_READ | AFD_POLL_ACCEPT))
+        pollfd.events |= POLLIN;
+    if ((mask & AFD_POLL_HUP) && type == SOCK_STREAM)
+        pollfd.events |= POLLIN;
+    if (mask & AFD_POLL_OOB)
+        pollfd.events |= oobinline ? POLLIN : POLLPRI;
+    if (mask & AFD_POLL_WRITE)
+        pollfd.events |= POLLOUT;
+
+    if (poll( &pollfd, 1, 0 ) < 0) return -1;
+    if (pollfd.revents & (POLLERR | POLLHUP | POLLNVAL)) return -1;
+
+    if ((mask & AFD_POLL_HUP) && (pollfd.revents & POLLIN) && type == SOCK_STREAM && !listening)
+    {
+        ssize_t ret;
+        char dummy;
+
+        /* A graceful close; let the server report AFD_POLL_HUP. */
+        ret = recv( fd, &dummy, 1, MSG_PEEK | MSG_DONTWAIT );
+        if (!ret || (ret < 0 && errno != EWOULDBLOCK)) return -1;
+    }
+
+    if (pollfd.revents & POLLIN)
+        flags |= listening ? AFD_POLL_ACCEPT : AFD_POLL_READ;
+    if (pollfd.revents & POLLPRI)
+        flags |= oobinline ? AFD_POLL_READ : AFD_POLL_OOB;
+    if (pollfd.revents & POLLOUT)
+        flags |= AFD_POLL_WRITE;
+    if (type == SOCK_STREAM && !listening)
+        flags |= AFD_POLL_CONNECT;
+
+    return flags & mask;
+}
+
+/* Answer a poll request without a server round trip if all of the sockets
+ * can be polled locally, and either the timeout is zero or at least one
+ * socket is already signaled. Requests which need to wait, exclusive polls
+ * and polls which complete through an APC or completion port still go
+ * through the server. */
+static NTSTATUS sock_poll_fast( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                                client_ptr_t io, const void *in_buffer, ULONG in_size,
+                                void *out_buffer, ULONG out_size )
+{
+    const struct afd_poll_params_32 *params32 = in_buffer;
+    const struct afd_poll_params_64 *params64 = in_buffer;
+    unsigned int i, count, signaled = 0;
+    BOOL wow64 = in_wow64_call();
+    LONGLONG timeout;
+    ULONG_PTR size;
+    int *flags;
+
+    if (apc || apc_user) return STATUS_BAD_DEVICE_TYPE;
+
+    if (wow64)
+    {
+        if (in_size < offsetof( struct afd_poll_params_32, sockets[0] )) return STATUS_BAD_DEVICE_TYPE;
+        count = params32->count;
+        timeout = params32->timeout;
+        if (params32->exclusive || !count || in_size < offsetof( struct afd_poll_params_32, sockets[count] ))
+            return STATUS_BAD_DEVICE_TYPE;
+    }
+    else
+    {
+        if (in_size < offsetof( struct afd_poll_params_64, sockets[0] )) return STATUS_BAD_DEVICE_TYPE;
+        count = params64->count;
+        timeout = params64->timeout;
+        if (params64->exclusive || !count || in_size < offsetof( struct afd_poll_params_64, sockets[count] ))
+            return STATUS_BAD_DEVICE_TYPE;
+    }
+
+    if (!(flags = malloc( count * sizeof(*flags) ))) return STATUS_BAD_DEVICE_TYPE;
+
+    for (i = 0; i < count; ++i)
+    {
+        HANDLE socket = wow64 ? ULongToHandle( params32->sockets[i].socket )
+                              : (HANDLE)(ULONG_PTR)params64->sockets[i].socket;
+        int mask = wow64 ? params32->sockets[i].flags : params64->sockets[i].flags;
+        enum server_fd_type type;
+        int fd, needs_close;
+
+        if (server_get_unix_fd( socket, 0, &fd, &needs_close, &type, NULL ))
+            break;
+        flags[i] = type == FD_TYPE_SOCKET ? poll_single_socket_fast( fd, mask ) : -1;
+        if (needs_close) close( fd );
+        if (flags[i] < 0) break;
+        if (flags[i]) ++signaled;
+    }
+
+    if (i < count || (timeout && !signaled))
+    {
+        free( flags );
+        return STATUS_BAD_DEVICE_TYPE;
+    }
+
+    /* Only the signaled sockets are returned, as in the server. */
+    if (wow64)
+    {
+        struct afd_poll_params_32 *output = out_buffer;
+        const struct afd_poll_params_32 input = *params32;
+        struct afd_poll_socket_32 *sockets;
+
+        size = offsetof( struct afd_poll_params_32, sockets[signaled] );
+        if (out_size < size || !(sockets = malloc( count * sizeof(*sockets) )))
+        {
+            free( flags );
+            return STATUS_BAD_DEVICE_TYPE;
+        }
+        memcpy( sockets, params32->sockets, count * sizeof(*sockets) );
+        memset( output, 0, size );
+        output->timeout = input.timeout;
+        output->exclusive = input.exclusive;
+        for (i = 0; i < count; ++i)
+        {
+            if (!flags[i]) continue;
+            output->sockets[output->count].socket = sockets[i].socket;
+            output->sockets[output->count].flags = flags[i];
+            ++output->count;
+        }
+        free( sockets );
+    }
+    else
+    {
+        struct afd_poll_params_64 *output = out_buffer;
+        const struct afd_poll_params_64 input = *params64;
+        struct afd_poll_socket_64 *sockets;
+
+        size = offsetof( struct afd_poll_params_64, sockets[signaled] );
+        if (out_size < size || !(sockets = malloc( count * sizeof(*sockets) )))
+        {
+            free( flags );
+            return STATUS_BAD_DEVICE_TYPE;
+        }
+        memcpy( sockets, params64->sockets, count * sizeof(*sockets) );
+        memset( output, 0, size );
+        output->timeout = input.timeout;
+        output->exclusive = input.exclusive;
+        for (i = 0; i < count; ++i)
+        {
+            if (!flags[i]) continue;
+            output->sockets[output->count].socket = sockets[i].socket;
+            output->sockets[output->count].flags = flags[i];
+            ++output->count;
+        }
+        free( sockets );
+    }
+    free( flags );
+
+    TRACE( "%u of %u sockets signaled\n", signaled, count );
+    complete_async( handle, event, apc, apc_user, io, STATUS_SUCCESS, size );
+    return STATUS_SUCCESS;
+}
+
 
 static NTSTATUS do_getsockopt( HANDLE handle, client_ptr_t io, int level,
                                int option, void *out_buffer, ULONG out_size )
@@ -1263,7 +1788,9 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
             break;
 
         case IOCTL_AFD_POLL:
-            status = STATUS_BAD_DEVICE_TYPE;
+            /* Falls back to the server with STATUS_BAD_DEVICE_TYPE. */
+            if (!(status = sock_poll_fast( handle, event, apc, apc_user, io, in_buffer, in_size, out_buffer, out_size )))
+                return status;
             break;
 
         case IOCTL_AFD_RECV:
@@ -1398,6 +1925,25 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
             return status;
         }
 
+        case IOCTL_AFD_WINE_TRANSMIT_PACKETS:
+        {
+            const struct afd_transmit_packets_params *params = in_buffer;
+
+            if ((status = server_get_unix_fd( handle, 0, &fd, &needs_close, NULL, NULL )))
+                return status;
+
+            if (in_size < sizeof(*params)
+                    || (in_size - sizeof(*params)) / sizeof(struct afd_transmit_packets_element) < params->count)
+            {
+                status = STATUS_BUFFER_TOO_SMALL;
+                break;
+            }
+            status = sock_transmit_packets( handle, event, apc, apc_user, io, fd, params,
+                                            (const struct afd_transmit_packets_element *)(params + 1) );
+            if (needs_close) close( fd );
+            return status;
+        }
+
         case IOCTL_AFD_WINE_COMPLETE_ASYNC:
         {
             if (in_size != sizeof(NTSTATUS))
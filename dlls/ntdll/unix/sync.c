@@ -1987,29 +1987,35 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE handle, ULONG_PTR *key, ULONG_PTR *
 NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
                                         ULONG *written, LARGE_INTEGER *timeout, BOOLEAN alertable )
 {
+    completion_msg_t msgs[64];
     NTSTATUS status;
-    ULONG i = 0;
+    ULONG i = 0, j, n;
 
     TRACE( "%p %p %u %p %p %u\n", handle, info, count, written, timeout, alertable );
 
     for (;;)
     {
+        /* fetch as many queued completions as possible with each request */
         while (i < count)
         {
-            SERVER_START_REQ( remove_completion )
+            n = min( count - i, ARRAY_SIZE(msgs) );
+            SERVER_START_REQ( remove_completions )
             {
                 req->handle = wine_server_obj_handle( handle );
+                wine_server_set_reply( req, msgs, n * sizeof(*msgs) );
                 if (!(status = wine_server_call( req )))
-                {
-                    info[i].CompletionKey             = reply->ckey;
-                    info[i].CompletionValue           = reply->cvalue;
-                    info[i].IoStatusBlock.Information = reply->information;
-                    info[i].IoStatusBlock.u.Status    = reply->status;
-                }
+                    n = wine_server_reply_size( reply ) / sizeof(*msgs);
             }
             SERVER_END_REQ;
             if (status != STATUS_SUCCESS) break;
-            ++i;
+            for (j = 0; j < n; j++, i++)
+            {
+                info[i].CompletionKey             = msgs[j].ckey;
+                info[i].CompletionValue           = msgs[j].cvalue;
+                info[i].IoStatusBlock.Information = msgs[j].information;
+                info[i].IoStatusBlock.u.Status    = msgs[j].status;
+            }
+            if (n < ARRAY_SIZE(msgs)) break;  /* the queue is empty */
         }
         if (i || status != STATUS_PENDING)
         {
@@ -30,6 +30,11 @@
 
 #include "tomcrypt.h"
 
+#if (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || __GNUC__ >= 5)
+#define USE_AES_NI
+#include <intrin.h>
+#endif
+
 static const ulong32 TE0[256] = {
     0xc66363a5UL, 0xf87c7c84UL, 0xee777799UL, 0xf67b7b8dUL,
     0xfff2f20dUL, 0xd66b6bbdUL, 0xde6f6fb1UL, 0x91c5c554UL,
@@ -1061,11 +1066,69 @@ int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey)
     return CRYPT_OK;
 }
 
+#ifdef USE_AES_NI
+
+static int aes_ni_supported(void)
+{
+    static int supported = -1;
+    int regs[4];
+
+    if (supported == -1) {
+        /* AES-NI, plus SSSE3 for byte swapping the round keys */
+        __cpuid(regs, 1);
+        supported = (regs[2] & (1 << 25)) && (regs[2] & (1 << 9));
+    }
+    return supported;
+}
+
+/* The round keys are stored as big endian words, as used by the tables. */
+static inline __m128i __attribute__((target("aes,ssse3"))) aes_ni_round_key(const ulong32 *rk)
+{
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)rk), bswap);
+}
+
+static void __attribute__((target("aes,ssse3"))) aes_ni_ecb_encrypt(const unsigned char *pt, unsigned char *ct,
+                                                                  const aes_key *skey)
+{
+    __m128i s;
+    int r;
+
+    s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pt), aes_ni_round_key(skey->eK));
+    for (r = 1; r < skey->Nr; r++)
+        s = _mm_aesenc_si128(s, aes_ni_round_key(skey->eK + 4 * r));
+    s = _mm_aesenclast_si128(s, aes_ni_round_key(skey->eK + 4 * r));
+    _mm_storeu_si128((__m128i *)ct, s);
+}
+
+/* dK holds the equivalent inverse cipher key schedule, which is what aesdec expects. */
+static void __attribute__((target("aes,ssse3"))) aes_ni_ecb_decrypt(const unsigned char *ct, unsigned char *pt,
+                                                                  const aes_key *skey)
+{
+    __m128i s;
+    int r;
+
+    s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ct), aes_ni_round_key(skey->dK));
+    for (r = 1; r < skey->Nr; r++)
+        s = _mm_aesdec_si128(s, aes_ni_round_key(skey->dK + 4 * r));
+    s = _mm_aesdeclast_si128(s, aes_ni_round_key(skey->dK + 4 * r));
+    _mm_storeu_si128((__m128i *)pt, s);
+}
+
+#endif /* USE_AES_NI */
+
 void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
 {
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef USE_AES_NI
+    if (aes_ni_supported()) {
+        aes_ni_ecb_encrypt(pt, ct, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->eK;
 
@@ -1167,6 +1230,13 @@ void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef USE_AES_NI
+    if (aes_ni_supported()) {
+        aes_ni_ecb_decrypt(ct, pt, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->dK;
 
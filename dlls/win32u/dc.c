@@ -282,15 +282,56 @@ void free_dc_ptr( DC *dc )
 }
 
 
+/***********************************************************************
+ *           flush_dc_batch
+ *
+ * Execute the drawing commands that gdi32 batched for the current thread.
+ */
+void flush_dc_batch( struct dc_batch *batch )
+{
+    UINT i, count = min( batch->count, DC_BATCH_SIZE );
+    HDC hdc = batch->hdc;
+
+    TRACE( "%p replaying %u commands\n", hdc, count );
+
+    /* reset first, the commands retrieve the DC again */
+    batch->count = 0;
+    for (i = 0; i < count; i++)
+    {
+        const INT *args = batch->entries[i].args;
+
+        switch (batch->entries[i].type)
+        {
+        case NTGDI_BATCH_PATBLT:
+            NtGdiPatBlt( hdc, args[0], args[1], args[2], args[3], args[4] );
+            break;
+        case NTGDI_BATCH_RECTANGLE:
+            NtGdiRectangle( hdc, args[0], args[1], args[2], args[3] );
+            break;
+        case NTGDI_BATCH_LINETO:
+            NtGdiLineTo( hdc, args[0], args[1] );
+            break;
+        default:
+            WARN( "unknown batch command %u\n", batch->entries[i].type );
+            break;
+        }
+    }
+}
+
+
 /***********************************************************************
  *           get_dc_ptr
  *
  * Retrieve a DC pointer but release the GDI lock.
+ * Commands batched by the current thread for the DC are executed first.
  */
 DC *get_dc_ptr( HDC hdc )
 {
-    DC *dc = get_dc_obj( hdc );
-    if (!dc) return NULL;
+    struct dc_batch *batch = NtUserGetThreadInfo()->gdi_batch;
+    DC *dc;
+
+    if (batch && batch->count && batch->hdc == hdc) flush_dc_batch( batch );
+    if (!(dc = get_dc_obj( hdc ))) return NULL;
     if (dc->attr->disabled)
     {
         GDI_ReleaseObj( hdc );
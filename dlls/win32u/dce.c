@@ -169,6 +169,7 @@ static void offscreen_window_surface_flush( struct window_surface *base )
     struct offscreen_window_surface *impl = impl_from_window_surface( base );
     base->funcs->lock( base );
     reset_bounds( &impl->bounds );
+    window_surface_reset_damage( base );
     base->funcs->unlock( base );
 }
 
@@ -307,7 +308,7 @@ static void dib_surface_set_region( struct window_surface *window_surface, HRGN
  */
 static void dib_surface_flush( struct window_surface *window_surface )
 {
-    /* nothing to do */
+    window_surface_reset_damage( window_surface );
 }
 
 /***********************************************************************
@@ -385,6 +386,62 @@ void register_window_surface( struct window_surface *old, struct window_surface
     pthread_mutex_unlock( &surfaces_lock );
 }
 
+/*******************************************************************
+ *           add_window_surface_damage
+ *
+ * Add a rectangle to the damage list of a window surface, merging it with the
+ * rectangles it touches so that the list stays disjoint. When the list is full,
+ * the rectangle is merged with the one that wastes the least area.
+ * The surface must be locked.
+ */
+void add_window_surface_damage( struct window_surface *surface, const RECT *rect )
+{
+    RECT rc = *rect, merged;
+    LONGLONG waste, best_waste;
+    UINT i, best;
+
+    if (surface == &dummy_surface || IsRectEmpty( &rc )) return;
+    if (surface->damage_count == WINDOW_SURFACE_DAMAGE_INVALID) return;
+
+restart:
+    for (i = 0; i < surface->damage_count; i++)
+    {
+        const RECT *damage = &surface->damage[i];
+
+        if (rc.left > damage->right || rc.right < damage->left ||
+            rc.top > damage->bottom || rc.bottom < damage->top)
+            continue;
+        union_rect( &rc, &rc, damage );
+        surface->damage[i] = surface->damage[--surface->damage_count];
+        goto restart;
+    }
+
+    if (surface->damage_count == WINDOW_SURFACE_MAX_DAMAGE)
+    {
+        best = 0;
+        best_waste = -1;
+        for (i = 0; i < surface->damage_count; i++)
+        {
+            const RECT *damage = &surface->damage[i];
+
+            union_rect( &merged, &rc, damage );
+            waste = (LONGLONG)(merged.right - merged.left) * (merged.bottom - merged.top) -
+                    (LONGLONG)(rc.right - rc.left) * (rc.bottom - rc.top) -
+                    (LONGLONG)(damage->right - damage->left) * (damage->bottom - damage->top);
+            if (best_waste == -1 || waste < best_waste)
+            {
+                best = i;
+                best_waste = waste;
+            }
+        }
+        union_rect( &rc, &rc, &surface->damage[best] );
+        surface->damage[best] = surface->damage[--surface->damage_count];
+        goto restart;
+    }
+
+    surface->damage[surface->damage_count++] = rc;
+}
+
 /*******************************************************************
  *           flush_window_surfaces
  *
@@ -854,6 +911,7 @@ static INT release_dc( HWND hwnd, HDC hdc, BOOL end_paint )
 
     TRACE( "%p %p\n", hwnd, hdc );
 
+    NtGdiFlush();  /* execute the batched commands before the DC gets disabled */
     user_lock();
     dce = get_dc_dce( hdc );
     if (dce && dce->count && dce->hwnd)
@@ -759,6 +759,8 @@ struct windrv_physdev
     struct dibdrv_physdev *dibdrv;
     struct window_surface *surface;
     DWORD                  start_ticks;
+    RECT                  *surface_bounds;  /* bounds saved while damage is accumulated for an operation */
+    RECT                   damage;          /* damage caused by the current operation */
 };
 
 static const struct gdi_dc_funcs window_driver;
@@ -773,10 +775,29 @@ static inline void lock_surface( struct windrv_physdev *dev )
     /* gdi_lock should not be locked */
     dev->surface->funcs->lock( dev->surface );
     if (IsRectEmpty( dev->dibdrv->bounds )) dev->start_ticks = NtGetTickCount();
+
+    /* accumulate the operation's damage separately so that it can be added to the surface damage list */
+    if (dev->dibdrv->bounds && dev->dibdrv->bounds == dev->surface->funcs->get_bounds( dev->surface ))
+    {
+        dev->surface_bounds = dev->dibdrv->bounds;
+        reset_bounds( &dev->damage );
+        dev->dibdrv->bounds = &dev->damage;
+    }
+}
+
+static inline void add_surface_damage( struct windrv_physdev *dev )
+{
+    if (!dev->surface_bounds) return;
+    dev->dibdrv->bounds = dev->surface_bounds;
+    dev->surface_bounds = NULL;
+    if (IsRectEmpty( &dev->damage )) return;
+    add_bounds_rect( dev->dibdrv->bounds, &dev->damage );
+    add_window_surface_damage( dev->surface, &dev->damage );
 }
 
 static inline void unlock_surface( struct windrv_physdev *dev )
 {
+    add_surface_damage( dev );
     dev->surface->funcs->unlock( dev->surface );
     if (NtGetTickCount() - dev->start_ticks > FLUSH_PERIOD) dev->surface->funcs->flush( dev->surface );
 }
@@ -983,6 +1004,7 @@ static DWORD CDECL windrv_GetImage( PHYSDEV dev, BITMAPINFO *info,
     if (!bits->is_copy)
     {
         /* use the freeing callback to unlock the surface */
+        add_surface_damage( physdev );
         assert( !bits->free );
         bits->free = unlock_bits_surface;
         bits->param = physdev->surface;
@@ -858,6 +858,9 @@ static struct wine_rb_tree family_name_tree = { family_name_compare };
 static struct wine_rb_tree family_second_name_tree = { family_second_name_compare };
 static struct wine_rb_tree face_full_name_tree = { face_full_name_compare };
 
+/* incremented every time a family or face is added, removed or reordered */
+static UINT font_list_generation;
+
 static int face_is_in_full_name_tree( const struct gdi_font_face *face )
 {
     return face->full_name_entry.parent || face_full_name_tree.root == &face->full_name_entry;
@@ -879,6 +882,7 @@ static struct gdi_font_family *create_family( const WCHAR *name, const WCHAR *se
     family->replacement = NULL;
     wine_rb_put( &family_name_tree, family->family_name, &family->name_entry );
     if (family->second_name[0]) wine_rb_put( &family_second_name_tree, family->second_name, &family->second_name_entry );
+    font_list_generation++;
     return family;
 }
 
@@ -890,6 +894,7 @@ static void release_family( struct gdi_font_family *family )
     if (family->second_name[0]) wine_rb_remove( &family_second_name_tree, &family->second_name_entry );
     if (family->replacement) release_family( family->replacement );
     heapfree( family );
+    font_list_generation++;
 }
 
 static struct gdi_font_family *find_family_from_name( const WCHAR *name )
@@ -1168,6 +1173,7 @@ static void set_default_family( DWORD pitch_and_family, WCHAR *default_name )
         wine_rb_remove( &family_name_tree, entry );
         lstrcpynW( default_name, name, LF_FACESIZE - 1 );
         wine_rb_put( &family_name_tree, name, entry );
+        font_list_generation++;
         return;
     }
 }
@@ -1186,6 +1192,7 @@ static void release_face( struct gdi_font_face *face )
     {
         if (face->flags & ADDFONT_ADD_TO_CACHE) remove_face_from_cache( face );
         list_remove( &face->entry );
+        font_list_generation++;
         release_family( face->family );
     }
     if (face_is_in_full_name_tree( face )) wine_rb_remove( &face_full_name_tree, &face->full_name_entry );
@@ -1280,6 +1287,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
                 TRACE("Replacing original %s with %s\n",
                       debugstr_w(cursor->file), debugstr_w(face->file));
                 list_add_before( &cursor->entry, &face->entry );
+                font_list_generation++;
                 face->family = family;
                 family->refcount++;
                 face->refcount++;
@@ -1298,6 +1306,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
     TRACE( "Adding face %s in family %s from %s\n", debugstr_w(face->full_name),
            debugstr_w(family->family_name), debugstr_w(face->file) );
     list_add_before( &cursor->entry, &face->entry );
+    font_list_generation++;
     if (face->scalable) wine_rb_put( &face_full_name_tree, face->full_name, &face->full_name_entry );
     face->family = family;
     family->refcount++;
@@ -3202,10 +3211,55 @@ static BOOL face_matches( const WCHAR *family_name, struct gdi_font_face *face,
     return !facename_compare( face_name, face->full_name, LF_FACESIZE - 1 );
 }
 
-static BOOL enum_face_charsets( const struct gdi_font_family *family, struct gdi_font_face *face,
-                                struct enum_charset *list, DWORD count, FONTENUMPROCW proc, LPARAM lparam,
-                                const WCHAR *subst )
+/* list of enumerated fonts, built under the font lock and passed to the callback without it */
+struct font_enum_list
+{
+    LONG                    refcount;
+    UINT                    generation;
+    UINT                    count;
+    UINT                    size;
+    struct font_enum_entry *entries;
+};
+
+/* cached enumeration of all families, indexed by requested charset */
+static struct font_enum_list *font_enum_cache[256];
+
+static struct font_enum_list *create_font_enum_list(void)
+{
+    struct font_enum_list *list;
+
+    if (!(list = calloc( 1, sizeof(*list) ))) return NULL;
+    list->refcount = 1;
+    list->generation = font_list_generation;
+    return list;
+}
+
+static void release_font_enum_list( struct font_enum_list *list )
+{
+    if (InterlockedDecrement( &list->refcount )) return;
+    free( list->entries );
+    free( list );
+}
+
+static struct font_enum_entry *add_font_enum_entry( struct font_enum_list *list )
+{
+    if (list->count == list->size)
+    {
+        UINT new_size = max( 64, list->size * 2 );
+        struct font_enum_entry *new_entries;
+
+        if (!(new_entries = realloc( list->entries, new_size * sizeof(*new_entries) ))) return NULL;
+        list->entries = new_entries;
+        list->size = new_size;
+    }
+    return &list->entries[list->count++];
+}
+
+static BOOL add_face_enum_entries( struct font_enum_list *enum_list, const struct gdi_font_family *family,
+                                   struct gdi_font_face *face, struct enum_charset *list, DWORD count,
+                                   const WCHAR *subst )
 {
+    struct font_enum_entry *entry;
     ENUMLOGFONTEXW elf;
     NEWTEXTMETRICEXW ntm;
     DWORD type, i;
@@ -3214,11 +3268,11 @@ static BOOL enum_face_charsets( const struct gdi_font_family *family, struct gdi
     {
         struct gdi_font_enum_data *data;
 
-        if (!(data = calloc( 1, sizeof(*data) )) ||
-            !get_face_enum_data( face, &data->elf, &data->ntm ))
+        if (!(data = calloc( 1, sizeof(*data) ))) return FALSE;
+        if (!get_face_enum_data( face, &data->elf, &data->ntm ))
         {
             heapfree( data );
-            return TRUE;
+            return TRUE;  /* skip faces that can't be loaded */
         }
         face->cached_enum_data = data;
     }
@@ -3256,23 +3310,77 @@ static BOOL enum_face_charsets( const struct gdi_font_family *family, struct gdi
                debugstr_w(elf.elfLogFont.lfFaceName), debugstr_w(elf.elfFullName), debugstr_w(elf.elfStyle),
                elf.elfLogFont.lfCharSet, type, debugstr_w(elf.elfScript),
                elf.elfLogFont.lfItalic, elf.elfLogFont.lfWeight, ntm.ntmTm.ntmFlags );
-        /* release section before callback (FIXME) */
-        pthread_mutex_unlock( &font_lock );
-        if (!proc( &elf.elfLogFont, (TEXTMETRICW *)&ntm, type, lparam )) return FALSE;
-        pthread_mutex_lock( &font_lock );
+        if (!(entry = add_font_enum_entry( enum_list ))) return FALSE;
+        entry->type = type;
+        entry->lf = elf;
+        entry->tm = ntm;
     }
     return TRUE;
 }
 
+static struct font_enum_list *get_family_enum_list( DWORD charset, struct enum_charset *list, DWORD count )
+{
+    struct font_enum_list *enum_list = font_enum_cache[charset & 0xff];
+    struct gdi_font_family *family;
+    struct gdi_font_face *face;
+
+    if (enum_list && enum_list->generation == font_list_generation)
+    {
+        InterlockedIncrement( &enum_list->refcount );
+        return enum_list;
+    }
+
+    TRACE( "building enumeration list for charset %d\n", charset );
+    if (!(enum_list = create_font_enum_list())) return NULL;
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+    {
+        face = LIST_ENTRY( list_head(get_family_face_list(family)), struct gdi_font_face, entry );
+        if (!add_face_enum_entries( enum_list, family, face, list, count, NULL ))
+        {
+            release_font_enum_list( enum_list );
+            return NULL;
+        }
+    }
+
+    if (font_enum_cache[charset & 0xff]) release_font_enum_list( font_enum_cache[charset & 0xff] );
+    font_enum_cache[charset & 0xff] = enum_list;
+    InterlockedIncrement( &enum_list->refcount );
+    return enum_list;
+}
+
+static struct font_enum_list *get_face_enum_list( const WCHAR *face_name, const WCHAR *orig_name,
+                                                  struct enum_charset *list, DWORD count )
+{
+    struct font_enum_list *enum_list;
+    struct gdi_font_family *family;
+    struct gdi_font_face *face;
+
+    if (!(enum_list = create_font_enum_list())) return NULL;
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+    {
+        if (!family_matches(family, face_name)) continue;
+        LIST_FOR_EACH_ENTRY( face, get_family_face_list(family), struct gdi_font_face, entry )
+        {
+            if (!face_matches( family->family_name, face, face_name )) continue;
+            if (!add_face_enum_entries( enum_list, family, face, list, count, orig_name ))
+            {
+                release_font_enum_list( enum_list );
+                return NULL;
+            }
+        }
+    }
+    return enum_list;
+}
+
 /*************************************************************
  * font_EnumFonts
  */
 static BOOL CDECL font_EnumFonts( PHYSDEV dev, LOGFONTW *lf, FONTENUMPROCW proc, LPARAM lparam )
 {
-    struct gdi_font_family *family;
-    struct gdi_font_face *face;
+    struct font_enum_list *enum_list;
     struct enum_charset enum_charsets[32];
-    DWORD count, charset;
+    DWORD count, charset, i;
+    BOOL ret = TRUE;
 
     charset = lf ? lf->lfCharSet : DEFAULT_CHARSET;
 
@@ -3293,29 +3401,24 @@ static BOOL CDECL font_EnumFonts( PHYSDEV dev, LOGFONTW *lf, FONTENUMPROCW proc,
         }
         else face_name = lf->lfFaceName;
 
-        WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
-        {
-            if (!family_matches(family, face_name)) continue;
-            LIST_FOR_EACH_ENTRY( face, get_family_face_list(family), struct gdi_font_face, entry )
-            {
-                if (!face_matches( family->family_name, face, face_name )) continue;
-                if (!enum_face_charsets( family, face, enum_charsets, count, proc, lparam, orig_name ))
-                    return FALSE;
-	    }
-	}
+        enum_list = get_face_enum_list( face_name, orig_name, enum_charsets, count );
     }
     else
     {
         TRACE( "charset %d\n", charset );
-        WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
-        {
-            face = LIST_ENTRY( list_head(get_family_face_list(family)), struct gdi_font_face, entry );
-            if (!enum_face_charsets( family, face, enum_charsets, count, proc, lparam, NULL ))
-                return FALSE;
-	}
+        enum_list = get_family_enum_list( charset, enum_charsets, count );
     }
     pthread_mutex_unlock( &font_lock );
-    return TRUE;
+
+    if (!enum_list) return FALSE;
+
+    /* the list is not modified once built, so the callback can be called without holding the lock */
+    for (i = 0; ret && i < enum_list->count; i++)
+        ret = proc( &enum_list->entries[i].lf.elfLogFont, (TEXTMETRICW *)&enum_list->entries[i].tm,
+                    enum_list->entries[i].type, lparam );
+
+    release_font_enum_list( enum_list );
+    return ret;
 }
 
 
@@ -4838,6 +4941,7 @@ struct font_enum
     ULONG size;
     ULONG count;
     ULONG charset;
+    BOOL  raster_able;
 };
 
 static INT WINAPI font_enum_proc( const LOGFONTW *lf, const TEXTMETRICW *tm,
@@ -4846,8 +4950,7 @@ static INT WINAPI font_enum_proc( const LOGFONTW *lf, const TEXTMETRICW *tm,
     struct font_enum *fe = (struct font_enum *)lp;
 
     if (fe->charset != DEFAULT_CHARSET && lf->lfCharSet != fe->charset) return 1;
-    if ((type & RASTER_FONTTYPE) && !(NtGdiGetDeviceCaps( fe->hdc, TEXTCAPS ) & TC_RA_ABLE))
-        return 1;
+    if ((type & RASTER_FONTTYPE) && !fe->raster_able) return 1;
 
     if (fe->buf && fe->count < fe->size)
     {
@@ -4882,6 +4985,7 @@ BOOL WINAPI NtGdiEnumFonts( HDC hdc, ULONG type, ULONG win32_compat, ULONG face_
     fe.size    = *count / sizeof(*fe.buf);
     fe.count   = 0;
     fe.charset = charset;
+    fe.raster_able = !!(NtGdiGetDeviceCaps( hdc, TEXTCAPS ) & TC_RA_ABLE);
 
     physdev = GET_DC_PHYSDEV( dc, pEnumFonts );
     ret = physdev->funcs->pEnumFonts( physdev, &lf, font_enum_proc, (LPARAM)&fe );
@@ -1000,7 +1000,10 @@ BOOL WINAPI NtGdiUnrealizeObject( HGDIOBJ obj )
  */
 BOOL WINAPI NtGdiFlush(void)
 {
-    return TRUE;  /* FIXME */
+    struct dc_batch *batch = NtUserGetThreadInfo()->gdi_batch;
+
+    if (batch && batch->count) flush_dc_batch( batch );
+    return TRUE;
 }
 
 
@@ -1103,6 +1103,7 @@ static void shm_surface_flush( struct window_surface *window_surface )
     window_surface->funcs->lock( window_surface );
     bounds = surface->bounds;
     reset_bounds( &surface->bounds );
+    window_surface_reset_damage( window_surface );
     window_surface->funcs->unlock( window_surface );
 
     if (IsRectEmpty( &bounds )) return;
@@ -165,6 +165,50 @@ static inline BOOL is_in_rect( const RECT *rect, int x, int y )
     return (rect->right > x && rect->left <= x && rect->bottom > y && rect->top <= y);
 }
 
+/* return the index of the first rectangle whose band ends below y */
+static int find_band_below( const WINEREGION *rgn, int y )
+{
+    int pos, start = 0, end = rgn->numRects;
+
+    while (start < end)
+    {
+        pos = (start + end) / 2;
+        if (rgn->rects[pos].bottom <= y) start = pos + 1;
+        else end = pos;
+    }
+    return start;
+}
+
+/* return the index of the first rectangle whose band starts at or below y */
+static int find_band_from( const WINEREGION *rgn, int y )
+{
+    int pos, start = 0, end = rgn->numRects;
+
+    while (start < end)
+    {
+        pos = (start + end) / 2;
+        if (rgn->rects[pos].top < y) start = pos + 1;
+        else end = pos;
+    }
+    return start;
+}
+
+/* restrict a region to the bands that intersect the [top,bottom) range, without copying the rectangles */
+static void get_region_bands( const WINEREGION *rgn, int top, int bottom, WINEREGION *bands )
+{
+    int first = find_band_below( rgn, top ), last = find_band_from( rgn, bottom );
+
+    bands->rects = rgn->rects + first;
+    bands->numRects = max( last - first, 0 );
+    bands->size = bands->numRects;
+    bands->extents = rgn->extents;
+    if (bands->numRects)
+    {
+        bands->extents.top = bands->rects[0].top;
+        bands->extents.bottom = bands->rects[bands->numRects - 1].bottom;
+    }
+}
+
 
 /*
  *     This file contains a few macros to help track
@@ -361,6 +405,7 @@ static BOOL REGION_IntersectRegion(WINEREGION *d, WINEREGION *s1, WINEREGION *s2
 static BOOL REGION_UnionRegion(WINEREGION *d, WINEREGION *s1, WINEREGION *s2);
 static BOOL REGION_SubtractRegion(WINEREGION *d, WINEREGION *s1, WINEREGION *s2);
 static BOOL REGION_XorRegion(WINEREGION *d, WINEREGION *s1, WINEREGION *s2);
+static INT REGION_Coalesce(WINEREGION *pReg, INT prevStart, INT curStart);
 static BOOL REGION_UnionRectWithRegion(const RECT *rect, WINEREGION *rgn);
 
 /***********************************************************************
@@ -1006,21 +1051,19 @@ BOOL WINAPI NtGdiRectInRegion( HRGN hrgn, const RECT *rect )
     {
 	if ((obj->numRects > 0) && overlapping(&obj->extents, &rc))
 	{
-	    for (i = region_find_pt( obj, rc.left, rc.top, &ret ); !ret && i < obj->numRects; i++ )
+	    i = region_find_pt( obj, rc.left, rc.top, &ret );
+	    while (!ret && i < obj->numRects && obj->rects[i].top < rc.bottom)
 	    {
-	        if (obj->rects[i].bottom <= rc.top)
-		    continue;             /* not far enough down yet */
-
-		if (obj->rects[i].top >= rc.bottom)
-		    break;                /* too far down */
-
 		if (obj->rects[i].right <= rc.left)
-		    continue;              /* not far enough over yet */
-
-		if (obj->rects[i].left >= rc.right)
-		    continue;
-
-		ret = TRUE;
+		    /* skip the rectangles on the left in this band */
+		    i = region_find_pt( obj, rc.left, obj->rects[i].top, &ret );
+		else if (obj->rects[i].left < rc.right)
+		    ret = TRUE;
+		else if (obj->rects[i].bottom < rc.bottom)
+		    /* nothing else in this band, jump to the next one */
+		    i = region_find_pt( obj, rc.left, obj->rects[i].bottom, &ret );
+		else
+		    break;
 	    }
 	}
 	GDI_ReleaseObj(hrgn);
@@ -1086,6 +1129,22 @@ static BOOL REGION_UnionRectWithRegion(const RECT *rect, WINEREGION *rgn)
 {
     WINEREGION region;
 
+    /* regions are often built band by band from top to bottom, in that case
+     * the rectangle can simply be appended as a new band */
+    if (rgn->numRects && rect->left < rect->right && rect->top < rect->bottom &&
+        rect->top >= rgn->extents.bottom)
+    {
+        INT prev_band = rgn->numRects - 1;
+
+        while (prev_band > 0 && rgn->rects[prev_band - 1].top == rgn->rects[prev_band].top) prev_band--;
+        if (!add_rect( rgn, rect->left, rect->top, rect->right, rect->bottom )) return FALSE;
+        REGION_Coalesce( rgn, prev_band, rgn->numRects - 1 );
+        rgn->extents.left = min( rgn->extents.left, rect->left );
+        rgn->extents.right = max( rgn->extents.right, rect->right );
+        rgn->extents.bottom = rect->bottom;
+        return TRUE;
+    }
+
     init_region( &region, 1 );
     region.numRects = 1;
     region.extents = *region.rects = *rect;
@@ -1850,12 +1909,25 @@ static BOOL REGION_IntersectO(WINEREGION *pReg,  RECT *r1, RECT *r1End,
 static BOOL REGION_IntersectRegion(WINEREGION *newReg, WINEREGION *reg1,
 				   WINEREGION *reg2)
 {
+    WINEREGION bands1, bands2;
+
    /* check for trivial reject */
     if ( (!(reg1->numRects)) || (!(reg2->numRects))  ||
 	(!overlapping(&reg1->extents, &reg2->extents)))
 	newReg->numRects = 0;
     else
-	if (!REGION_RegionOp (newReg, reg1, reg2, REGION_IntersectO, NULL, NULL)) return FALSE;
+    {
+        /* only the bands in the common vertical range can contribute to the result */
+        INT top = max( reg1->extents.top, reg2->extents.top );
+        INT bottom = min( reg1->extents.bottom, reg2->extents.bottom );
+
+        get_region_bands( reg1, top, bottom, &bands1 );
+        get_region_bands( reg2, top, bottom, &bands2 );
+        if (!bands1.numRects || !bands2.numRects)
+            newReg->numRects = 0;
+        else if (!REGION_RegionOp( newReg, &bands1, &bands2, REGION_IntersectO, NULL, NULL ))
+            return FALSE;
+    }
 
     /*
      * Can't alter newReg's extents before we call miRegionOp because
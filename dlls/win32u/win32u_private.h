@@ -352,6 +352,7 @@ extern ULONG_PTR set_icon_param( HICON handle, ULONG_PTR param ) DECLSPEC_HIDDEN
 
 /* dce.c */
 extern struct window_surface dummy_surface DECLSPEC_HIDDEN;
+extern void add_window_surface_damage( struct window_surface *surface, const RECT *rect ) DECLSPEC_HIDDEN;
 extern BOOL create_dib_surface( HDC hdc, const BITMAPINFO *info ) DECLSPEC_HIDDEN;
 extern void create_offscreen_window_surface( const RECT *visible_rect,
                                              struct window_surface **surface ) DECLSPEC_HIDDEN;
@@ -25,6 +25,7 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
 #define WINED3D_BUFFER_HASDESC      0x01    /* A vertex description has been found. */
 #define WINED3D_BUFFER_USE_BO       0x02    /* Use a buffer object for this buffer. */
@@ -34,6 +35,10 @@ WINE_DEFAULT_DEBUG_CHANNEL(d3d);
 #define VB_MAXFULLCONVERSIONS 5       /* Number of full conversions before we stop converting */
 #define VB_RESETFULLCONVS     20      /* Reset full conversion counts after that number of draws */
 
+#define SB_MIN_SIZE           (512 * 1024)          /* Initial size of streaming buffers */
+#define SB_MAX_GROW_SIZE      (16 * 1024 * 1024)    /* Don't grow streaming buffers past this on wrap */
+#define SB_MIN_WRAP_UPLOADS   64      /* Grow streaming buffers that wrap after fewer uploads than this */
+
 struct wined3d_buffer_ops
 {
     BOOL (*buffer_prepare_location)(struct wined3d_buffer *buffer,
@@ -1669,7 +1674,7 @@ HRESULT CDECL wined3d_buffer_create(struct wined3d_device *device, const struct
 }
 
 static HRESULT wined3d_streaming_buffer_prepare(struct wined3d_device *device,
-        struct wined3d_streaming_buffer *buffer, unsigned int min_size)
+        struct wined3d_streaming_buffer *buffer, unsigned int min_size, BOOL grow)
 {
     struct wined3d_buffer *wined3d_buffer;
     struct wined3d_buffer_desc desc;
@@ -1680,11 +1685,11 @@ static HRESULT wined3d_streaming_buffer_prepare(struct wined3d_device *device,
     if (buffer->buffer)
     {
         old_size = buffer->buffer->resource.size;
-        if (old_size >= min_size)
+        if (old_size >= min_size && !grow)
             return S_OK;
     }
 
-    size = max(old_size * 2, min_size);
+    size = max(SB_MIN_SIZE, max(old_size * 2, min_size));
     TRACE("Growing buffer to %u bytes.\n", size);
 
     desc.byte_width = size;
@@ -1700,6 +1705,7 @@ static HRESULT wined3d_streaming_buffer_prepare(struct wined3d_device *device,
             wined3d_buffer_decref(buffer->buffer);
         buffer->buffer = wined3d_buffer;
         buffer->pos = 0;
+        buffer->upload_count = 0;
     }
     return hr;
 }
@@ -1712,12 +1718,27 @@ HRESULT CDECL wined3d_streaming_buffer_upload(struct wined3d_device *device, str
     struct wined3d_map_desc map_desc;
     unsigned int pos, align;
     struct wined3d_box box;
+    BOOL grow = FALSE;
     HRESULT hr;
 
     TRACE("device %p, buffer %p, data %p, size %u, stride %u, ret_pos %p.\n",
             device, buffer, data, size, stride, ret_pos);
 
-    if (FAILED(hr = wined3d_streaming_buffer_prepare(device, buffer, size)))
+    /* Every wrap discards the buffer, which means renaming it to a new BO.
+     * If that happens after only a handful of uploads, the buffer is too
+     * small for the application's per-frame working set; grow it instead, so
+     * that most uploads can use NOOVERWRITE maps. */
+    if (buffer->buffer)
+    {
+        resource = &buffer->buffer->resource;
+        if ((align = buffer->pos % stride))
+            align = stride - align;
+        if (buffer->pos + size + align > resource->size
+                && buffer->upload_count < SB_MIN_WRAP_UPLOADS && resource->size < SB_MAX_GROW_SIZE)
+            grow = TRUE;
+    }
+
+    if (FAILED(hr = wined3d_streaming_buffer_prepare(device, buffer, size, grow)))
         return hr;
     resource = &buffer->buffer->resource;
 
@@ -1728,6 +1749,10 @@ HRESULT CDECL wined3d_streaming_buffer_upload(struct wined3d_device *device, str
     {
         pos = 0;
         map_flags |= WINED3D_MAP_DISCARD;
+        ++buffer->wrap_count;
+        TRACE_(d3d_perf)("Streaming buffer %p wrapped after %u uploads; %u wraps, 0x%s bytes streamed.\n",
+                buffer, buffer->upload_count, buffer->wrap_count, wine_dbgstr_longlong(buffer->bytes_streamed));
+        buffer->upload_count = 0;
     }
     else
     {
@@ -1742,6 +1767,8 @@ HRESULT CDECL wined3d_streaming_buffer_upload(struct wined3d_device *device, str
         wined3d_resource_unmap(resource, 0);
         *ret_pos = pos;
         buffer->pos = pos + size;
+        ++buffer->upload_count;
+        buffer->bytes_streamed += size;
     }
     return hr;
 }
@@ -111,6 +111,7 @@ enum wined3d_cs_op
     WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE,
     WINED3D_CS_OP_SET_RASTERIZER_STATE,
     WINED3D_CS_OP_SET_RENDER_STATE,
+    WINED3D_CS_OP_SET_RENDER_STATES,
     WINED3D_CS_OP_SET_TEXTURE_STATE,
     WINED3D_CS_OP_SET_SAMPLER_STATE,
     WINED3D_CS_OP_SET_TRANSFORM,
@@ -348,6 +349,13 @@ struct wined3d_cs_set_render_state
     DWORD value;
 };
 
+struct wined3d_cs_set_render_states
+{
+    enum wined3d_cs_op opcode;
+    unsigned int count;
+    struct wined3d_render_state_value states[1];
+};
+
 struct wined3d_cs_set_texture_state
 {
     enum wined3d_cs_op opcode;
@@ -594,6 +602,7 @@ static const char *debug_cs_op(enum wined3d_cs_op op)
         WINED3D_TO_STR(WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE);
         WINED3D_TO_STR(WINED3D_CS_OP_SET_RASTERIZER_STATE);
         WINED3D_TO_STR(WINED3D_CS_OP_SET_RENDER_STATE);
+        WINED3D_TO_STR(WINED3D_CS_OP_SET_RENDER_STATES);
         WINED3D_TO_STR(WINED3D_CS_OP_SET_TEXTURE_STATE);
         WINED3D_TO_STR(WINED3D_CS_OP_SET_SAMPLER_STATE);
         WINED3D_TO_STR(WINED3D_CS_OP_SET_TRANSFORM);
@@ -1772,6 +1781,40 @@ void wined3d_device_context_emit_set_render_state(struct wined3d_device_context
     wined3d_device_context_submit(context, WINED3D_CS_QUEUE_DEFAULT);
 }
 
+static void wined3d_cs_exec_set_render_states(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_set_render_states *op = data;
+    unsigned int i;
+
+    for (i = 0; i < op->count; ++i)
+    {
+        cs->state.render_states[op->states[i].state] = op->states[i].value;
+        device_invalidate_state(cs->c.device, STATE_RENDER(op->states[i].state));
+    }
+}
+
+/* Emits several render states in a single packet, which saves the per-packet
+ * queue overhead when a state block changes many of them at once. */
+void wined3d_device_context_emit_set_render_states(struct wined3d_device_context *context,
+        unsigned int count, const struct wined3d_render_state_value *states)
+{
+    struct wined3d_cs_set_render_states *op;
+
+    if (count == 1)
+    {
+        wined3d_device_context_emit_set_render_state(context, states[0].state, states[0].value);
+        return;
+    }
+
+    op = wined3d_device_context_require_space(context,
+            FIELD_OFFSET(struct wined3d_cs_set_render_states, states[count]), WINED3D_CS_QUEUE_DEFAULT);
+    op->opcode = WINED3D_CS_OP_SET_RENDER_STATES;
+    op->count = count;
+    memcpy(op->states, states, count * sizeof(*states));
+
+    wined3d_device_context_submit(context, WINED3D_CS_QUEUE_DEFAULT);
+}
+
 static void wined3d_cs_exec_set_texture_state(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_set_texture_state *op = data;
@@ -2392,6 +2435,10 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
         return WINED3D_OK;
     }
 
+    if (flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_NOOVERWRITE))
+        WARN_(d3d_perf)("Stalling on a %s map of resource %p.\n",
+                flags & WINED3D_MAP_DISCARD ? "DISCARD" : "NOOVERWRITE", resource);
+
     wined3d_resource_wait_idle(resource);
 
     /* We might end up invalidating the resource on the CS thread. */
@@ -2848,6 +2895,7 @@ static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void
     /* WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE     */ wined3d_cs_exec_set_depth_stencil_state,
     /* WINED3D_CS_OP_SET_RASTERIZER_STATE        */ wined3d_cs_exec_set_rasterizer_state,
     /* WINED3D_CS_OP_SET_RENDER_STATE            */ wined3d_cs_exec_set_render_state,
+    /* WINED3D_CS_OP_SET_RENDER_STATES           */ wined3d_cs_exec_set_render_states,
     /* WINED3D_CS_OP_SET_TEXTURE_STATE           */ wined3d_cs_exec_set_texture_state,
     /* WINED3D_CS_OP_SET_SAMPLER_STATE           */ wined3d_cs_exec_set_sampler_state,
     /* WINED3D_CS_OP_SET_TRANSFORM               */ wined3d_cs_exec_set_transform,
@@ -3347,11 +3395,13 @@ static void wined3d_cs_exec_execute_command_list(struct wined3d_cs *cs, const vo
 
 static DWORD WINAPI wined3d_cs_run(void *ctx)
 {
+    unsigned int spin_limit = WINED3D_CS_SPIN_COUNT;
     struct wined3d_cs_queue *queue;
     unsigned int spin_count = 0;
     struct wined3d_cs *cs = ctx;
     HMODULE wined3d_module;
     unsigned int poll = 0;
+    bool waited = false;
     bool run = true;
 
     TRACE("Started.\n");
@@ -3379,11 +3429,24 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             queue = &cs->queue[WINED3D_CS_QUEUE_DEFAULT];
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
-                if (++spin_count >= WINED3D_CS_SPIN_COUNT && list_empty(&cs->query_poll_list))
+                if (++spin_count >= spin_limit && list_empty(&cs->query_poll_list))
+                {
                     wined3d_cs_wait_event(cs);
+                    waited = true;
+                }
                 continue;
             }
         }
+
+        /* Adapt the spin limit to the observed gaps between packets. If we
+         * had to block, spinning was wasted, so give up sooner next time. If
+         * work arrived late in the spin, spin longer so that the next gap of
+         * that size doesn't cost a wakeup. */
+        if (waited)
+            spin_limit = max(spin_limit / 2, WINED3D_CS_SPIN_COUNT_MIN);
+        else if (spin_count > spin_limit / 2)
+            spin_limit = min(spin_limit * 2, WINED3D_CS_SPIN_COUNT);
+        waited = false;
         spin_count = 0;
 
         run = wined3d_cs_execute_next(cs, queue);
@@ -1895,6 +1895,7 @@ void CDECL wined3d_device_context_reset_state(struct wined3d_device_context *con
 
 void CDECL wined3d_device_context_set_state(struct wined3d_device_context *context, struct wined3d_state *state)
 {
+    struct wined3d_render_state_value render_states[WINEHIGHEST_RENDER_STATE + 1];
     const struct wined3d_light_info *light;
     unsigned int i, j;
 
@@ -1988,11 +1989,15 @@ void CDECL wined3d_device_context_set_state(struct wined3d_device_context *conte
         }
     }
 
-    for (i = 0; i < WINEHIGHEST_RENDER_STATE + 1; ++i)
+    for (i = 0, j = 0; i < WINEHIGHEST_RENDER_STATE + 1; ++i)
     {
-        if (context->device->state_table[STATE_RENDER(i)].representative)
-            wined3d_device_context_emit_set_render_state(context, i, state->render_states[i]);
+        if (!context->device->state_table[STATE_RENDER(i)].representative)
+            continue;
+        render_states[j].state = i;
+        render_states[j++].value = state->render_states[i];
     }
+    if (j)
+        wined3d_device_context_emit_set_render_states(context, j, render_states);
 
     wined3d_device_context_emit_set_blend_state(context, state->blend_state, &state->blend_factor, state->sample_mask);
     wined3d_device_context_emit_set_depth_stencil_state(context, state->depth_stencil_state, state->stencil_ref);
@@ -3886,8 +3891,9 @@ void CDECL wined3d_device_apply_stateblock(struct wined3d_device *device,
     const struct wined3d_stateblock_state *state = &stateblock->stateblock_state;
     const struct wined3d_saved_states *changed = &stateblock->changed;
     const unsigned int word_bit_count = sizeof(DWORD) * CHAR_BIT;
+    struct wined3d_render_state_value render_states[WINEHIGHEST_RENDER_STATE + 1];
     struct wined3d_device_context *context = &device->cs->c;
-    unsigned int i, j, start, idx;
+    unsigned int i, j, start, idx, render_state_count = 0;
     struct wined3d_range range;
     uint32_t map;
 
@@ -4019,12 +4025,30 @@ void CDECL wined3d_device_apply_stateblock(struct wined3d_device *device,
                     set_rasterizer_state = TRUE;
                     break;
 
-                default:
+                case WINED3D_RS_POINTSIZE:
+                    /* May trigger a RESZ resolve, which should see the
+                     * render states set before it. */
+                    if (render_state_count)
+                    {
+                        wined3d_device_context_emit_set_render_states(context,
+                                render_state_count, render_states);
+                        render_state_count = 0;
+                    }
                     wined3d_device_set_render_state(device, idx, state->rs[idx]);
                     break;
+
+                default:
+                    if (state->rs[idx] == device->cs->c.state->render_states[idx])
+                        break;
+                    device->cs->c.state->render_states[idx] = state->rs[idx];
+                    render_states[render_state_count].state = idx;
+                    render_states[render_state_count++].value = state->rs[idx];
+                    break;
             }
         }
     }
+    if (render_state_count)
+        wined3d_device_context_emit_set_render_states(context, render_state_count, render_states);
 
     if (set_rasterizer_state)
     {
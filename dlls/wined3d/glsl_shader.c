@@ -138,6 +138,10 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL ffp_proj_control;
     BOOL legacy_lighting;
+
+    uint64_t driver_hash;
+    unsigned int program_cache_hits;
+    unsigned int program_cache_misses;
 };
 
 struct glsl_vs_program
@@ -644,6 +648,219 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+/* Linked programs are stored on disk when GL_ARB_get_program_binary is
+ * available and a "ProgramCachePath" is configured. The cache key covers the
+ * GL driver identity, the source of every attached shader and the state that
+ * affects linking without showing up in the source. */
+#define WINED3D_GLSL_PROGRAM_CACHE_MAGIC 0x42504757u /* "WGPB" */
+
+struct glsl_program_cache_header
+{
+    uint32_t magic;
+    uint32_t size;
+    uint64_t key;
+    GLenum format;
+};
+
+static uint64_t shader_glsl_hash(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *ptr = data;
+
+    /* 64-bit FNV-1a. */
+    while (size--)
+        hash = (hash ^ *ptr++) * 0x100000001b3ull;
+    return hash;
+}
+
+static uint64_t shader_glsl_hash_string(uint64_t hash, const GLubyte *str)
+{
+    return str ? shader_glsl_hash(hash, str, strlen((const char *)str) + 1) : hash;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_get_program_cache_key(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint32_t link_flags, uint64_t *key)
+{
+    GLint i, shader_count, source_size = 0;
+    char *source = NULL;
+    GLuint *shaders;
+    uint64_t hash;
+
+    if (!priv->driver_hash)
+    {
+        hash = 0xcbf29ce484222325ull;
+        hash = shader_glsl_hash_string(hash, gl_info->gl_ops.gl.p_glGetString(GL_VENDOR));
+        hash = shader_glsl_hash_string(hash, gl_info->gl_ops.gl.p_glGetString(GL_RENDERER));
+        hash = shader_glsl_hash_string(hash, gl_info->gl_ops.gl.p_glGetString(GL_VERSION));
+        hash = shader_glsl_hash_string(hash, gl_info->gl_ops.gl.p_glGetString(GL_SHADING_LANGUAGE_VERSION_ARB));
+        priv->driver_hash = hash;
+    }
+
+    hash = shader_glsl_hash(priv->driver_hash, &link_flags, sizeof(link_flags));
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_ATTACHED_SHADERS, &shader_count));
+    if (!(shaders = heap_calloc(shader_count, sizeof(*shaders))))
+        return FALSE;
+    GL_EXTCALL(glGetAttachedShaders(program_id, shader_count, NULL, shaders));
+
+    for (i = 0; i < shader_count; ++i)
+    {
+        GLint length, type;
+
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type));
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        if (source_size < length)
+        {
+            heap_free(source);
+            if (!(source = heap_alloc(length)))
+            {
+                heap_free(shaders);
+                return FALSE;
+            }
+            source_size = length;
+        }
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size, &length, source));
+        hash = shader_glsl_hash(hash, &type, sizeof(type));
+        hash = shader_glsl_hash(hash, source, length);
+    }
+    checkGLcall("get program cache key");
+
+    heap_free(source);
+    heap_free(shaders);
+    *key = hash;
+    return TRUE;
+}
+
+static void shader_glsl_get_program_cache_file_name(uint64_t key, char *name, size_t size)
+{
+    snprintf(name, size, "%s\\%08x%08x.bin", wined3d_settings.program_cache_path,
+            (unsigned int)(key >> 32), (unsigned int)key);
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_load_program_binary(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t key)
+{
+    struct glsl_program_cache_header header;
+    char name[MAX_PATH];
+    void *data = NULL;
+    GLint status = 0;
+    HANDLE file;
+    DWORD size;
+
+    shader_glsl_get_program_cache_file_name(key, name, sizeof(name));
+    if ((file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (ReadFile(file, &header, sizeof(header), &size, NULL) && size == sizeof(header)
+            && header.magic == WINED3D_GLSL_PROGRAM_CACHE_MAGIC && header.key == key
+            && (data = heap_alloc(header.size))
+            && ReadFile(file, data, header.size, &size, NULL) && size == header.size)
+    {
+        GL_EXTCALL(glProgramBinary(program_id, header.format, data, header.size));
+        GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+        checkGLcall("glProgramBinary");
+    }
+    heap_free(data);
+    CloseHandle(file);
+
+    if (!status)
+    {
+        /* Typically a driver update the version string didn't reflect. */
+        WARN("Failed to load program binary %s.\n", debugstr_a(name));
+        return FALSE;
+    }
+
+    TRACE("Loaded program %u from %s.\n", program_id, debugstr_a(name));
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_store_program_binary(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, uint64_t key)
+{
+    struct glsl_program_cache_header header;
+    char name[MAX_PATH], tmp_name[MAX_PATH];
+    GLint status, length;
+    void *data;
+    HANDLE file;
+    DWORD size;
+    BOOL ret;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (!status || length <= 0 || !(data = heap_alloc(length)))
+        return;
+
+    memset(&header, 0, sizeof(header));
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &header.format, data));
+    checkGLcall("glGetProgramBinary");
+    header.magic = WINED3D_GLSL_PROGRAM_CACHE_MAGIC;
+    header.size = length;
+    header.key = key;
+
+    /* Write to a temporary file first, so that concurrent processes never
+     * see a partially written entry. */
+    shader_glsl_get_program_cache_file_name(key, name, sizeof(name));
+    snprintf(tmp_name, sizeof(tmp_name), "%s.%x", name, GetCurrentProcessId());
+    if ((file = CreateFileA(tmp_name, GENERIC_WRITE, 0, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create %s, error %u.\n", debugstr_a(tmp_name), GetLastError());
+        heap_free(data);
+        return;
+    }
+    ret = WriteFile(file, &header, sizeof(header), &size, NULL) && size == sizeof(header)
+            && WriteFile(file, data, length, &size, NULL) && size == length;
+    CloseHandle(file);
+    heap_free(data);
+
+    if (!ret || !MoveFileExA(tmp_name, name, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to write %s, error %u.\n", debugstr_a(name), GetLastError());
+        DeleteFileA(tmp_name);
+        return;
+    }
+
+    TRACE("Stored program %u in %s.\n", program_id, debugstr_a(name));
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_link_program(struct shader_glsl_priv *priv, const struct wined3d_gl_info *gl_info,
+        GLuint program_id, BOOL cacheable, uint32_t link_flags)
+{
+    WORD old_fpu_cw;
+    uint64_t key;
+
+    cacheable = cacheable && wined3d_settings.program_cache_path && gl_info->supported[ARB_GET_PROGRAM_BINARY]
+            && shader_glsl_get_program_cache_key(priv, gl_info, program_id, link_flags, &key);
+    if (cacheable)
+    {
+        if (shader_glsl_load_program_binary(priv, gl_info, program_id, key))
+        {
+            ++priv->program_cache_hits;
+            return;
+        }
+        ++priv->program_cache_misses;
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+
+    old_fpu_cw = wined3d_get_fpu_cw();
+    if (old_fpu_cw != WINED3D_DEFAULT_FPU_CW)
+        wined3d_set_fpu_cw(WINED3D_DEFAULT_FPU_CW);
+
+    GL_EXTCALL(glLinkProgram(program_id));
+
+    if (old_fpu_cw != WINED3D_DEFAULT_FPU_CW)
+        wined3d_set_fpu_cw(old_fpu_cw);
+
+    if (cacheable)
+        shader_glsl_store_program_binary(gl_info, program_id, key);
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -10415,8 +10632,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
+    shader_glsl_link_program(priv, gl_info, program_id, TRUE, 0);
     shader_glsl_validate_link(gl_info, program_id);
 
     GL_EXTCALL(glUseProgram(program_id));
@@ -10499,7 +10715,6 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     GLuint gs_id = 0;
     GLuint ps_id = 0;
     struct list *ps_list, *vs_list;
-    WORD old_fpu_cw;
     struct wined3d_string_buffer *tmp_name;
 
     if (!(context_gl->c.shader_update_mask & (1u << WINED3D_SHADER_TYPE_VERTEX)) && ctx_data->glsl_program)
@@ -10750,18 +10965,10 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-
-    old_fpu_cw = wined3d_get_fpu_cw();
-    if (old_fpu_cw != WINED3D_DEFAULT_FPU_CW)
-        wined3d_set_fpu_cw(WINED3D_DEFAULT_FPU_CW);
-
-    GL_EXTCALL(glLinkProgram(program_id));
-
-    if (old_fpu_cw != WINED3D_DEFAULT_FPU_CW)
-        wined3d_set_fpu_cw(old_fpu_cw);
-
+    /* Link the program. Transform feedback varyings aren't part of any
+     * shader source, so those programs are never cached. */
+    shader_glsl_link_program(priv, gl_info, program_id, !gshader || !gshader->u.gs.so_desc,
+            state->blend_state && state->blend_state->dual_source);
     shader_glsl_validate_link(gl_info, program_id);
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
@@ -11351,6 +11558,9 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
 
     wine_rb_init(&priv->program_lookup, glsl_program_key_compare);
 
+    if (wined3d_settings.program_cache_path)
+        CreateDirectoryA(wined3d_settings.program_cache_path, NULL);
+
     priv->next_constant_version = 1;
     priv->vertex_pipe = vertex_pipe;
     priv->fragment_pipe = fragment_pipe;
@@ -11380,6 +11590,9 @@ static void shader_glsl_free(struct wined3d_device *device, struct wined3d_conte
 {
     struct shader_glsl_priv *priv = device->shader_priv;
 
+    if (priv->program_cache_hits || priv->program_cache_misses)
+        TRACE("Program cache: %u hits, %u misses.\n", priv->program_cache_hits, priv->program_cache_misses);
+
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
@@ -842,37 +842,30 @@ static void convert_r5g5_snorm_l6_unorm(const BYTE *src, BYTE *dst, UINT src_row
 static void convert_r5g5_snorm_l6_unorm_ext(const BYTE *src, BYTE *dst, UINT src_row_pitch, UINT src_slice_pitch,
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
-    unsigned int x, y, z;
-    unsigned char *texel_out, r_out, g_out, r_in, g_in, l_in;
+    unsigned int x, y, z, r_out, g_out, r_in, g_in, l_in;
     const unsigned short *texel_in;
+    DWORD *texel_out;
 
+    /* The texels are written as whole DWORDs and the "r > 0" / "g > 0"
+     * replication is done with a mask instead of a branch, so that the
+     * compiler can vectorise the inner loop. */
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
             texel_in = (const unsigned short *)(src + z * src_slice_pitch + y * src_row_pitch);
-            texel_out = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            texel_out = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
             for (x = 0; x < width; x++ )
             {
-                l_in = (*texel_in & 0xfc00u) >> 10;
-                g_in = (*texel_in & 0x03e0u) >> 5;
-                r_in = *texel_in & 0x001fu;
+                l_in = (texel_in[x] & 0xfc00u) >> 10;
+                g_in = (texel_in[x] & 0x03e0u) >> 5;
+                r_in = texel_in[x] & 0x001fu;
 
-                r_out = r_in << 3;
-                if (!(r_in & 0x10)) /* r > 0 */
-                    r_out |= r_in >> 1;
+                /* r > 0, g > 0 */
+                r_out = r_in << 3 | ((r_in >> 1) & ((r_in >> 4) - 1));
+                g_out = g_in << 3 | ((g_in >> 1) & ((g_in >> 4) - 1));
 
-                g_out = g_in << 3;
-                if (!(g_in & 0x10)) /* g > 0 */
-                    g_out |= g_in >> 1;
-
-                texel_out[0] = r_out;
-                texel_out[1] = g_out;
-                texel_out[2] = l_in << 1 | l_in >> 5;
-                texel_out[3] = 0;
-
-                texel_out += 4;
-                texel_in++;
+                texel_out[x] = r_out | g_out << 8 | (l_in << 1 | l_in >> 5) << 16;
             }
         }
     }
@@ -954,25 +947,27 @@ static void convert_r8g8_snorm_l8x8_unorm(const BYTE *src, BYTE *dst, UINT src_r
 {
     unsigned int x, y, z;
     const DWORD *Source;
-    unsigned char *Dest;
+    DWORD *Dest;
 
     /* Doesn't work correctly with the fixed function pipeline, but can work in
      * shaders if the shader is adjusted. (There's no use for this format in gl's
      * standard fixed function pipeline anyway).
-     */
+     *
+     * Adding 128 to a byte is the same as flipping its top bit, which lets us
+     * bias all channels of a texel with a single XOR. */
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
             Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            Dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
             for (x = 0; x < width; x++ )
             {
-                LONG color = (*Source++);
-                /* B */ Dest[0] = ((color >> 16) & 0xff);       /* L */
-                /* G */ Dest[1] = ((color >> 8 ) & 0xff) + 128; /* V */
-                /* R */ Dest[2] = (color         & 0xff) + 128; /* U */
-                Dest += 4;
+                DWORD color = Source[x];
+                Dest[x] = (((color >> 16) & 0xff)       /* B = L */
+                        | (color & 0xff00)              /* G = V */
+                        | (color & 0xff) << 16)         /* R = U */
+                        ^ 0x00808000;
             }
         }
     }
@@ -983,7 +978,7 @@ static void convert_r8g8_snorm_l8x8_unorm_nv(const BYTE *src, BYTE *dst, UINT sr
 {
     unsigned int x, y, z;
     const DWORD *Source;
-    unsigned char *Dest;
+    DWORD *Dest;
 
     /* This implementation works with the fixed function pipeline and shaders
      * without further modification after converting the surface.
@@ -993,15 +988,11 @@ static void convert_r8g8_snorm_l8x8_unorm_nv(const BYTE *src, BYTE *dst, UINT sr
         for (y = 0; y < height; y++)
         {
             Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            Dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
             for (x = 0; x < width; x++ )
             {
-                LONG color = (*Source++);
-                /* L */ Dest[2] = ((color >> 16) & 0xff);   /* L */
-                /* V */ Dest[1] = ((color >> 8 ) & 0xff);   /* V */
-                /* U */ Dest[0] = (color         & 0xff);   /* U */
-                /* I */ Dest[3] = 255;                      /* X */
-                Dest += 4;
+                /* U, V and L are kept in place, I = 255. */
+                Dest[x] = Source[x] | 0xff000000;
             }
         }
     }
@@ -1012,22 +1003,21 @@ static void convert_r8g8b8a8_snorm(const BYTE *src, BYTE *dst, UINT src_row_pitc
 {
     unsigned int x, y, z;
     const DWORD *Source;
-    unsigned char *Dest;
+    DWORD *Dest;
 
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
             Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            Dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
             for (x = 0; x < width; x++ )
             {
-                LONG color = (*Source++);
-                /* B */ Dest[0] = ((color >> 16) & 0xff) + 128; /* W */
-                /* G */ Dest[1] = ((color >> 8 ) & 0xff) + 128; /* V */
-                /* R */ Dest[2] = (color         & 0xff) + 128; /* U */
-                /* A */ Dest[3] = ((color >> 24) & 0xff) + 128; /* Q */
-                Dest += 4;
+                DWORD color = Source[x];
+                Dest[x] = (((color >> 16) & 0xff)       /* B = W */
+                        | (color & 0xff00ff00)          /* G = V, A = Q */
+                        | (color & 0xff) << 16)         /* R = U */
+                        ^ 0x80808080;
             }
         }
     }
@@ -1186,10 +1176,21 @@ static BOOL color_in_range(const struct wined3d_color_key *color_key, DWORD colo
             && color <= color_key->color_space_high_value;
 }
 
+/* Returns "mask" if "color" is outside the color key range, and 0 otherwise.
+ * The destination rows may alias the color key as far as the compiler is
+ * concerned, so the converters below copy the key to the stack first; with
+ * that and no branches in the inner loop the compiler is able to vectorise
+ * it. */
+static inline DWORD color_key_mask(const struct wined3d_color_key *color_key, DWORD color, DWORD mask)
+{
+    return color_in_range(color_key, color) ? 0 : mask;
+}
+
 static void convert_b5g6r5_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, unsigned int src_pitch,
         BYTE *dst, unsigned int dst_pitch, unsigned int width, unsigned int height,
         const struct wined3d_color_key *color_key)
 {
+    const struct wined3d_color_key key = *color_key;
     const WORD *src_row;
     unsigned int x, y;
     WORD *dst_row;
@@ -1201,10 +1202,8 @@ static void convert_b5g6r5_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, unsig
         for (x = 0; x < width; ++x)
         {
             WORD src_color = src_row[x];
-            if (!color_in_range(color_key, src_color))
-                dst_row[x] = 0x8000u | ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
-            else
-                dst_row[x] = ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
+            dst_row[x] = color_key_mask(&key, src_color, 0x8000u)
+                    | ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
         }
     }
 }
@@ -1213,6 +1212,7 @@ static void convert_b5g5r5x1_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, uns
         BYTE *dst, unsigned int dst_pitch, unsigned int width, unsigned int height,
         const struct wined3d_color_key *color_key)
 {
+    const struct wined3d_color_key key = *color_key;
     const WORD *src_row;
     unsigned int x, y;
     WORD *dst_row;
@@ -1224,10 +1224,7 @@ static void convert_b5g5r5x1_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             WORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                dst_row[x] = src_color & ~0x8000;
-            else
-                dst_row[x] = src_color | 0x8000;
+            dst_row[x] = (src_color & ~0x8000) | color_key_mask(&key, src_color, 0x8000u);
         }
     }
 }
@@ -1236,6 +1233,7 @@ static void convert_b8g8r8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, unsig
         BYTE *dst, unsigned int dst_pitch, unsigned int width, unsigned int height,
         const struct wined3d_color_key *color_key)
 {
+    const struct wined3d_color_key key = *color_key;
     const BYTE *src_row;
     unsigned int x, y;
     DWORD *dst_row;
@@ -1247,7 +1245,7 @@ static void convert_b8g8r8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, unsig
         for (x = 0; x < width; ++x)
         {
             DWORD src_color = (src_row[x * 3 + 2] << 16) | (src_row[x * 3 + 1] << 8) | src_row[x * 3];
-            if (!color_in_range(color_key, src_color))
+            if (!color_in_range(&key, src_color))
                 dst_row[x] = src_color | 0xff000000;
         }
     }
@@ -1257,6 +1255,7 @@ static void convert_b8g8r8x8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         BYTE *dst, unsigned int dst_pitch, unsigned int width, unsigned int height,
         const struct wined3d_color_key *color_key)
 {
+    const struct wined3d_color_key key = *color_key;
     const DWORD *src_row;
     unsigned int x, y;
     DWORD *dst_row;
@@ -1268,10 +1267,7 @@ static void convert_b8g8r8x8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             DWORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                dst_row[x] = src_color & ~0xff000000;
-            else
-                dst_row[x] = src_color | 0xff000000;
+            dst_row[x] = (src_color & ~0xff000000) | color_key_mask(&key, src_color, 0xff000000);
         }
     }
 }
@@ -1280,6 +1276,7 @@ static void convert_b8g8r8a8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         BYTE *dst, unsigned int dst_pitch, unsigned int width, unsigned int height,
         const struct wined3d_color_key *color_key)
 {
+    const struct wined3d_color_key key = *color_key;
     const DWORD *src_row;
     unsigned int x, y;
     DWORD *dst_row;
@@ -1291,9 +1288,7 @@ static void convert_b8g8r8a8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             DWORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                src_color &= ~0xff000000;
-            dst_row[x] = src_color;
+            dst_row[x] = src_color & (0x00ffffff | color_key_mask(&key, src_color, 0xff000000));
         }
     }
 }
@@ -176,6 +176,7 @@ static void macdrv_surface_flush(struct window_surface *window_surface)
     }
     update_blit_data(surface);
     reset_bounds(&surface->bounds);
+    window_surface_reset_damage(window_surface);
 
     window_surface->funcs->unlock(window_surface);
 
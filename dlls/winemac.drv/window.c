@@ -522,6 +522,7 @@ static void sync_window_opacity(struct macdrv_win_data *data, COLORREF key, BYTE
         data->surface->funcs->lock(data->surface);
         bounds = data->surface->funcs->get_bounds(data->surface);
         add_bounds_rect(bounds, &rect);
+        window_surface_invalidate_damage(data->surface);
         data->surface->funcs->unlock(data->surface);
     }
 }
@@ -2130,6 +2131,7 @@ BOOL macdrv_UpdateLayeredWindow(HWND hwnd, const UPDATELAYEREDWINDOWINFO *info,
             surface->funcs->lock(surface);
             memcpy(dst_bits, src_bits, bmi->bmiHeader.biSizeImage);
             add_bounds_rect(surface->funcs->get_bounds(surface), &rect);
+            window_surface_invalidate_damage(surface);
             surface->funcs->unlock(surface);
             surface->funcs->flush(surface);
         }
@@ -416,6 +416,127 @@ static void wine_vk_device_free(struct wine_device *device)
     free(device);
 }
 
+/* Conversion contexts spill into heap blocks once their on-stack buffer is
+ * full. Allocations are carved out of fixed size blocks, and released blocks
+ * are kept in a small per-thread cache, so that large submissions and
+ * descriptor updates don't call malloc() for every converted struct. */
+#define CONVERSION_BLOCK_SIZE (64 * 1024)
+#define CONVERSION_CACHE_MAX_BLOCKS 4
+
+struct conversion_block
+{
+    struct list entry;
+    size_t size;
+    size_t used;
+    UINT64 data[1];
+};
+
+struct conversion_block_cache
+{
+    struct list blocks;
+    unsigned int count;
+};
+
+static pthread_key_t conversion_cache_key;
+static pthread_once_t conversion_cache_once = PTHREAD_ONCE_INIT;
+
+static void free_conversion_block_cache(void *arg)
+{
+    struct conversion_block_cache *cache = arg;
+    struct conversion_block *block, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE(block, next, &cache->blocks, struct conversion_block, entry)
+        free(block);
+    free(cache);
+}
+
+static void init_conversion_cache_key(void)
+{
+    pthread_key_create(&conversion_cache_key, free_conversion_block_cache);
+}
+
+static struct conversion_block_cache *get_conversion_block_cache(void)
+{
+    struct conversion_block_cache *cache;
+
+    pthread_once(&conversion_cache_once, init_conversion_cache_key);
+    if ((cache = pthread_getspecific(conversion_cache_key)))
+        return cache;
+
+    if (!(cache = malloc(sizeof(*cache))))
+        return NULL;
+    list_init(&cache->blocks);
+    cache->count = 0;
+    if (pthread_setspecific(conversion_cache_key, cache))
+    {
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void *conversion_context_alloc_block(struct conversion_context *pool, size_t size)
+{
+    struct conversion_block_cache *cache;
+    struct conversion_block *block = NULL;
+    struct list *entry;
+    void *ret;
+
+    size = (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
+
+    if ((entry = list_tail(&pool->alloc_entries)))
+    {
+        block = LIST_ENTRY(entry, struct conversion_block, entry);
+        if (block->size - block->used < size)
+            block = NULL;
+    }
+
+    if (!block)
+    {
+        if (size <= CONVERSION_BLOCK_SIZE && (cache = get_conversion_block_cache())
+                && (entry = list_head(&cache->blocks)))
+        {
+            list_remove(entry);
+            --cache->count;
+            block = LIST_ENTRY(entry, struct conversion_block, entry);
+        }
+        else
+        {
+            size_t block_size = size > CONVERSION_BLOCK_SIZE ? size : CONVERSION_BLOCK_SIZE;
+
+            if (!(block = malloc(offsetof(struct conversion_block, data[0]) + block_size)))
+                return NULL;
+            block->size = block_size;
+        }
+        block->used = 0;
+        list_add_tail(&pool->alloc_entries, &block->entry);
+    }
+
+    ret = (char *)block->data + block->used;
+    block->used += size;
+    return ret;
+}
+
+void conversion_context_release_blocks(struct conversion_context *pool)
+{
+    struct conversion_block_cache *cache = get_conversion_block_cache();
+    struct conversion_block *block, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE(block, next, &pool->alloc_entries, struct conversion_block, entry)
+    {
+        list_remove(&block->entry);
+        if (cache && block->size == CONVERSION_BLOCK_SIZE && cache->count < CONVERSION_CACHE_MAX_BLOCKS)
+        {
+            list_add_head(&cache->blocks, &block->entry);
+            ++cache->count;
+        }
+        else
+        {
+            free(block);
+        }
+    }
+}
+
 NTSTATUS init_vulkan(void *args)
 {
     vk_funcs = (const struct vulkan_funcs *)args;
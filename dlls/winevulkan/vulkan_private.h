@@ -264,11 +264,13 @@ static inline void init_conversion_context(struct conversion_context *pool)
     list_init(&pool->alloc_entries);
 }
 
+void *conversion_context_alloc_block(struct conversion_context *pool, size_t size) DECLSPEC_HIDDEN;
+void conversion_context_release_blocks(struct conversion_context *pool) DECLSPEC_HIDDEN;
+
 static inline void free_conversion_context(struct conversion_context *pool)
 {
-    struct list *entry, *next;
-    LIST_FOR_EACH_SAFE(entry, next, &pool->alloc_entries)
-        free(entry);
+    if (!list_empty(&pool->alloc_entries))
+        conversion_context_release_blocks(pool);
 }
 
 static inline void *conversion_context_alloc(struct conversion_context *pool, size_t size)
@@ -279,14 +281,8 @@ static inline void *conversion_context_alloc(struct conversion_context *pool, si
         pool->used += (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
         return ret;
     }
-    else
-    {
-        struct list *entry;
-        if (!(entry = malloc(sizeof(*entry) + size)))
-            return NULL;
-        list_add_tail(&pool->alloc_entries, entry);
-        return entry + 1;
-    }
+
+    return conversion_context_alloc_block(pool, size);
 }
 
 typedef UINT32 PTR32;
@@ -1904,62 +1904,63 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
     struct x11drv_window_surface *surface = get_x11_surface( window_surface );
     unsigned char *src = surface->bits;
     unsigned char *dst = (unsigned char *)surface->image->data;
-    struct bitblt_coords coords;
+    RECT rect, rects[WINDOW_SURFACE_MAX_DAMAGE];
+    UINT i, count;
+    BOOL updated = FALSE;
 
     window_surface->funcs->lock( window_surface );
-    coords.x = 0;
-    coords.y = 0;
-    coords.width  = surface->header.rect.right - surface->header.rect.left;
-    coords.height = surface->header.rect.bottom - surface->header.rect.top;
-    SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
-    if (IntersectRect( &coords.visrect, &coords.visrect, &surface->bounds ))
+    count = window_surface_get_damage( window_surface, &surface->bounds, rects );
+    for (i = 0; i < count; i++)
     {
-        TRACE( "flushing %p %dx%d bounds %s bits %p\n",
-               surface, coords.width, coords.height,
-               wine_dbgstr_rect( &surface->bounds ), surface->bits );
+        SetRect( &rect, 0, 0, surface->header.rect.right - surface->header.rect.left,
+                 surface->header.rect.bottom - surface->header.rect.top );
+        if (!IntersectRect( &rect, &rect, &rects[i] )) continue;
+
+        TRACE( "flushing %p bounds %s rect %s (%u/%u) bits %p\n",
+               surface, wine_dbgstr_rect( &surface->bounds ), wine_dbgstr_rect( &rect ),
+               i + 1, count, surface->bits );
 
-        if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
+        if (!updated && (surface->is_argb || surface->color_key != CLR_INVALID))
+            update_surface_region( surface );
+        updated = TRUE;
 
         if (src != dst)
         {
             int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
             int width_bytes = surface->image->bytes_per_line;
 
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
+            copy_image_byteswap( &surface->info, src + rect.top * width_bytes, dst + rect.top * width_bytes,
+                                 width_bytes, width_bytes, rect.bottom - rect.top,
                                  surface->byteswap, mapping, ~0u, surface->alpha_bits );
         }
         else if (surface->alpha_bits)
         {
             int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
-            ULONG *ptr = (ULONG *)dst + coords.visrect.top * stride;
+            ULONG *ptr = (ULONG *)dst + rect.top * stride;
 
-            for (y = coords.visrect.top; y < coords.visrect.bottom; y++, ptr += stride)
-                for (x = coords.visrect.left; x < coords.visrect.right; x++)
+            for (y = rect.top; y < rect.bottom; y++, ptr += stride)
+                for (x = rect.left; x < rect.right; x++)
                     ptr[x] |= surface->alpha_bits;
         }
 
 #ifdef HAVE_LIBXXSHM
         if (surface->shminfo.shmid != -1)
             XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
+                          rect.left, rect.top,
+                          surface->header.rect.left + rect.left,
+                          surface->header.rect.top + rect.top,
+                          rect.right - rect.left, rect.bottom - rect.top, False );
         else
 #endif
         XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
-        XFlush( gdi_display );
+                   rect.left, rect.top,
+                   surface->header.rect.left + rect.left,
+                   surface->header.rect.top + rect.top,
+                   rect.right - rect.left, rect.bottom - rect.top );
     }
+    if (updated) XFlush( gdi_display );
     reset_bounds( &surface->bounds );
+    window_surface_reset_damage( window_surface );
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -2104,6 +2105,7 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
     window_surface->funcs->lock( window_surface );
     OffsetRect( &rc, -window_surface->rect.left, -window_surface->rect.top );
     add_bounds_rect( &surface->bounds, &rc );
+    window_surface_invalidate_damage( window_surface );
     if (surface->region)
     {
         region = NtGdiCreateRectRgn( rect->left, rect->top, rect->right, rect->bottom );
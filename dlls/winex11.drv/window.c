@@ -2870,6 +2870,7 @@ BOOL X11DRV_UpdateLayeredWindow( HWND hwnd, const UPDATELAYEREDWINDOWINFO *info,
     {
         memcpy( dst_bits, src_bits, bmi->bmiHeader.biSizeImage );
         add_bounds_rect( surface->funcs->get_bounds( surface ), &rect );
+        window_surface_invalidate_damage( surface );
     }
 
     surface->funcs->unlock( surface );
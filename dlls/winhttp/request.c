@@ -1407,15 +1407,36 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
     FreeLibraryWhenCallbackReturns( instance, winhttp_instance );
 }
 
-static void cache_connection( struct netconn *netconn )
+static void cache_connection( struct netconn *netconn, const struct session *session, DWORD max_conns )
 {
+    struct netconn *old, *prev;
+    DWORD count = 0;
+
     TRACE( "caching connection %p\n", netconn );
 
     EnterCriticalSection( &connection_pool_cs );
 
+    netconn->session = session;
     netconn->keep_until = GetTickCount64() + DEFAULT_KEEP_ALIVE_TIMEOUT;
     list_add_head( &netconn->host->connections, &netconn->entry );
 
+    /* cap the idle connections this session keeps to the host; the pool is shared between
+     * sessions, so only connections cached by this one count toward its limit. Idle
+     * connections are reused from the head, so the least recently used ones are dropped. */
+    LIST_FOR_EACH_ENTRY( old, &netconn->host->connections, struct netconn, entry )
+        if (old->session == session) count++;
+
+    LIST_FOR_EACH_ENTRY_SAFE_REV( old, prev, &netconn->host->connections, struct netconn, entry )
+    {
+        if (count <= max_conns) break;
+        if (old->session != session) continue;
+
+        TRACE( "idle connection limit %lu reached, freeing %p\n", max_conns, old );
+        list_remove( &old->entry );
+        netconn_close( old );
+        count--;
+    }
+
     if (!connection_collector_running)
     {
         HMODULE module;
@@ -1829,7 +1850,12 @@ static void finished_reading( struct request *request )
     if (close)
         netconn_close( request->netconn );
     else
-        cache_connection( request->netconn );
+    {
+        struct session *session = request->connect->session;
+
+        cache_connection( request->netconn, session, request->http_1_0_server ?
+                          session->max_conns_per_1_0_server : session->max_conns_per_server );
+    }
     request->netconn = NULL;
 }
 
@@ -2473,6 +2499,7 @@ static DWORD read_reply( struct request *request )
 
     free( request->version );
     request->version = versionW;
+    request->http_1_0_server = !wcscmp( versionW, L"HTTP/1.0" );
 
     len = buflen - (status_text - buffer);
     if (!(status_textW = malloc( len * sizeof(WCHAR) ))) return ERROR_OUTOFMEMORY;
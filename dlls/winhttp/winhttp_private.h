@@ -84,6 +84,8 @@ struct session
     HANDLE unload_event;
     DWORD secure_protocols;
     DWORD passport_flags;
+    DWORD max_conns_per_server;
+    DWORD max_conns_per_1_0_server;
 };
 
 struct connect
@@ -107,6 +109,7 @@ struct netconn
     struct sockaddr_storage sockaddr;
     BOOL secure; /* SSL active on connection? */
     struct hostdata *host;
+    const struct session *session; /* session that cached the connection, only used for comparison */
     ULONGLONG keep_until;
     CtxtHandle ssl_ctx;
     SecPkgContext_StreamSizes ssl_sizes;
@@ -195,6 +198,7 @@ struct request
     DWORD max_redirects;
     DWORD redirect_count; /* total number of redirects during this request */
     WCHAR *status_text;
+    BOOL  http_1_0_server; /* did the last response come from an HTTP/1.0 server? */
     DWORD content_length; /* total number of bytes to be read */
     DWORD content_read;   /* bytes read so far */
     BOOL  read_chunked;   /* are we reading in chunked mode? */
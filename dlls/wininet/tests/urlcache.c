@@ -1182,9 +1182,101 @@ static void test_GetUrlCacheConfigInfo(void)
     }
 }
 
+#define GROW_ENTRIES 512
+
+static void commit_grow_entries(const char *name)
+{
+    static const FILETIME filetime_zero;
+    char url[INTERNET_MAX_URL_LENGTH];
+    BOOL ret;
+    int i;
+
+    for (i = 0; i < GROW_ENTRIES; i++)
+    {
+        sprintf(url, "Visited: user@http://urlcachetest.winehq.org/%s%d.html", name, i);
+        ret = CommitUrlCacheEntryA(url, NULL, filetime_zero, filetime_zero, NORMAL_CACHE_ENTRY, NULL, 0, "html", NULL);
+        ok(ret, "CommitUrlCacheEntry(%s) failed with error %ld\n", url, GetLastError());
+    }
+}
+
+static void check_grow_entries(const char *name, BOOL delete)
+{
+    INTERNET_CACHE_ENTRY_INFOA *info;
+    char url[INTERNET_MAX_URL_LENGTH];
+    FILETIME modified;
+    DWORD size;
+    BOOL ret;
+    int i;
+
+    info = HeapAlloc(GetProcessHeap(), 0, 4096);
+    for (i = 0; i < GROW_ENTRIES; i++)
+    {
+        sprintf(url, "Visited: user@http://urlcachetest.winehq.org/%s%d.html", name, i);
+
+        size = 4096;
+        ret = GetUrlCacheEntryInfoA(url, info, &size);
+        ok(ret, "GetUrlCacheEntryInfo(%s) failed with error %ld\n", url, GetLastError());
+        if (ret)
+            ok(!strcmp(info->lpszSourceUrlName, url), "got %s, expected %s\n", info->lpszSourceUrlName, url);
+
+        ret = IsUrlCacheEntryExpiredA(url, 0, &modified);
+        ok(!ret, "%s is expired\n", url);
+
+        if (delete)
+        {
+            ret = pDeleteUrlCacheEntryA(url);
+            ok(ret, "DeleteUrlCacheEntry(%s) failed with error %ld\n", url, GetLastError());
+        }
+    }
+    HeapFree(GetProcessHeap(), 0, info);
+}
+
+static void test_index_growth(char *argv0)
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH * 2];
+    BOOL ret;
+
+    if (!pDeleteUrlCacheEntryA)
+    {
+        win_skip("DeleteUrlCacheEntryA not available\n");
+        return;
+    }
+
+    /* enough entries to resize the index and chain several hash tables,
+     * the lookups have to use the index mapped again after each resize */
+    commit_grow_entries("grow");
+    check_grow_entries("grow", FALSE);
+
+    /* the index keeps growing in another process while this one has it mapped */
+    sprintf(cmdline, "\"%s\" urlcache grow", argv0);
+    ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+    ok(ret, "CreateProcess failed with error %ld\n", GetLastError());
+    if (ret)
+    {
+        wait_child_process(pi.hProcess);
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+        check_grow_entries("child", TRUE);
+    }
+
+    check_grow_entries("grow", TRUE);
+}
+
 START_TEST(urlcache)
 {
     HMODULE hdll;
+    char **argv;
+    int argc;
+
+    argc = winetest_get_mainargs(&argv);
+    if (argc > 2 && !strcmp(argv[2], "grow"))
+    {
+        commit_grow_entries("child");
+        return;
+    }
+
     hdll = GetModuleHandleA("wininet.dll");
 
     if(!GetProcAddress(hdll, "InternetGetCookieExW")) {
@@ -1207,4 +1299,5 @@ START_TEST(urlcache)
     test_GetDiskInfoA();
     test_trailing_slash();
     test_GetUrlCacheConfigInfo();
+    test_index_growth(argv[0]);
 }
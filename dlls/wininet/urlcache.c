@@ -182,8 +182,13 @@ typedef struct
     char *cache_prefix; /* string that has to be prefixed for this container to be used */
     LPWSTR path; /* path to url container directory */
     HANDLE mapping; /* handle of file mapping */
+    urlcache_header *header; /* view of the mapping, kept while the mapping is open */
     DWORD file_size; /* size of file when mapping was opened */
     HANDLE mutex; /* handle of mutex */
+    LONG *sequence; /* shared with other processes, odd while the index is being modified */
+    HANDLE sequence_mapping; /* handle of mapping holding the sequence counter */
+    DWORD write_depth; /* how many times the mutex is held by this process */
+    SRWLOCK view_lock; /* protects header against the lock-free lookups in this process */
     DWORD default_entry_type;
 } cache_container;
 
@@ -388,6 +393,24 @@ static void cache_container_create_object_name(LPWSTR lpszPath, WCHAR replace)
     }
 }
 
+/* Caller must hold container mutex.
+ *
+ * The index may be read without the mutex (see cache_container_find_entry),
+ * so every writer makes the shared sequence counter odd while it holds the
+ * mutex and even again when it releases it. The mutex is recursive, only the
+ * outermost acquisition updates the counter. */
+static void cache_container_begin_write(cache_container *container)
+{
+    if(!container->write_depth++ && container->sequence && !(*container->sequence & 1))
+        InterlockedIncrement(container->sequence);
+}
+
+static void cache_container_end_write(cache_container *container)
+{
+    if(!--container->write_depth && container->sequence)
+        InterlockedIncrement(container->sequence);
+}
+
 /* Caller must hold container lock */
 static HANDLE cache_container_map_index(HANDLE file, const WCHAR *path, DWORD size, BOOL *validate)
 {
@@ -624,7 +647,11 @@ static DWORD cache_container_open_index(cache_container *container, DWORD blocks
         blocks_no = MAX_BLOCK_NO;
 
     if(file_size < FILE_SIZE(blocks_no)) {
-        DWORD ret = cache_container_set_size(container, file, blocks_no);
+        DWORD ret;
+
+        cache_container_begin_write(container);
+        ret = cache_container_set_size(container, file, blocks_no);
+        cache_container_end_write(container);
         CloseHandle(file);
         ReleaseMutex(container->mutex);
         return ret;
@@ -670,8 +697,17 @@ static DWORD cache_container_open_index(cache_container *container, DWORD blocks
  */
 static void cache_container_close_index(cache_container *pContainer)
 {
+    WaitForSingleObject(pContainer->mutex, INFINITE);
+    if (pContainer->header)
+    {
+        AcquireSRWLockExclusive(&pContainer->view_lock);
+        UnmapViewOfFile(pContainer->header);
+        pContainer->header = NULL;
+        ReleaseSRWLockExclusive(&pContainer->view_lock);
+    }
     CloseHandle(pContainer->mapping);
     pContainer->mapping = NULL;
+    ReleaseMutex(pContainer->mutex);
 }
 
 static BOOL cache_containers_add(const char *cache_prefix, LPCWSTR path,
@@ -679,6 +715,7 @@ static BOOL cache_containers_add(const char *cache_prefix, LPCWSTR path,
 {
     cache_container *pContainer = heap_alloc(sizeof(cache_container));
     int cache_prefix_len = strlen(cache_prefix);
+    WCHAR sequence_name[MAX_PATH];
 
     if (!pContainer)
     {
@@ -686,7 +723,11 @@ static BOOL cache_containers_add(const char *cache_prefix, LPCWSTR path,
     }
 
     pContainer->mapping = NULL;
+    pContainer->header = NULL;
     pContainer->file_size = 0;
+    pContainer->sequence = NULL;
+    pContainer->write_depth = 0;
+    InitializeSRWLock(&pContainer->view_lock);
     pContainer->default_entry_type = default_entry_type;
 
     pContainer->path = heap_strdupW(path);
@@ -717,6 +758,18 @@ static BOOL cache_containers_add(const char *cache_prefix, LPCWSTR path,
         return FALSE;
     }
 
+    /* lookups fall back to taking the mutex if the counter can't be shared */
+    wsprintfW(sequence_name, L"%sindex.dat_sequence", path);
+    cache_container_create_object_name(sequence_name, '_');
+    pContainer->sequence_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL,
+            PAGE_READWRITE, 0, sizeof(LONG), sequence_name);
+    if (pContainer->sequence_mapping &&
+            !(pContainer->sequence = MapViewOfFile(pContainer->sequence_mapping, FILE_MAP_WRITE, 0, 0, 0)))
+    {
+        CloseHandle(pContainer->sequence_mapping);
+        pContainer->sequence_mapping = NULL;
+    }
+
     list_add_head(&UrlContainers, &pContainer->entry);
 
     return TRUE;
@@ -727,6 +780,9 @@ static void cache_container_delete_container(cache_container *pContainer)
     list_remove(&pContainer->entry);
 
     cache_container_close_index(pContainer);
+    if (pContainer->sequence)
+        UnmapViewOfFile(pContainer->sequence);
+    CloseHandle(pContainer->sequence_mapping);
     CloseHandle(pContainer->mutex);
     heap_free(pContainer->path);
     heap_free(pContainer->cache_prefix);
@@ -887,27 +943,37 @@ static urlcache_header* cache_container_lock_index(cache_container *pContainer)
 
     /* acquire mutex */
     WaitForSingleObject(pContainer->mutex, INFINITE);
+    cache_container_begin_write(pContainer);
 
-    pIndexData = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
-
-    if (!pIndexData)
+    /* the view is kept until the index is closed, so that lookups
+     * don't have to map and unmap the whole file every time */
+    if (!pContainer->header)
     {
-        ReleaseMutex(pContainer->mutex);
-        ERR("Couldn't MapViewOfFile. Error: %ld\n", GetLastError());
-        return NULL;
+        pIndexData = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
+
+        if (!pIndexData)
+        {
+            cache_container_end_write(pContainer);
+            ReleaseMutex(pContainer->mutex);
+            ERR("Couldn't MapViewOfFile. Error: %ld\n", GetLastError());
+            return NULL;
+        }
+        AcquireSRWLockExclusive(&pContainer->view_lock);
+        pContainer->header = pIndexData;
+        ReleaseSRWLockExclusive(&pContainer->view_lock);
     }
-    pHeader = (urlcache_header*)pIndexData;
+    pHeader = pContainer->header;
 
     /* file has grown - we need to remap to prevent us getting
      * access violations when we try and access beyond the end
      * of the memory mapped file */
     if (pHeader->size != pContainer->file_size)
     {
-        UnmapViewOfFile( pHeader );
         cache_container_close_index(pContainer);
         error = cache_container_open_index(pContainer, MIN_BLOCK_NO);
         if (error != ERROR_SUCCESS)
         {
+            cache_container_end_write(pContainer);
             ReleaseMutex(pContainer->mutex);
             SetLastError(error);
             return NULL;
@@ -916,11 +982,14 @@ static urlcache_header* cache_container_lock_index(cache_container *pContainer)
 
         if (!pIndexData)
         {
+            cache_container_end_write(pContainer);
             ReleaseMutex(pContainer->mutex);
             ERR("Couldn't MapViewOfFile. Error: %ld\n", GetLastError());
             return NULL;
         }
-        pHeader = (urlcache_header*)pIndexData;
+        AcquireSRWLockExclusive(&pContainer->view_lock);
+        pHeader = pContainer->header = pIndexData;
+        ReleaseSRWLockExclusive(&pContainer->view_lock);
     }
 
     TRACE("Signature: %s, file size: %ld bytes\n", pHeader->signature, pHeader->size);
@@ -939,9 +1008,10 @@ static urlcache_header* cache_container_lock_index(cache_container *pContainer)
  */
 static BOOL cache_container_unlock_index(cache_container *pContainer, urlcache_header *pHeader)
 {
-    /* release mutex */
+    /* release mutex, the view stays mapped for the next lookup */
+    cache_container_end_write(pContainer);
     ReleaseMutex(pContainer->mutex);
-    return UnmapViewOfFile(pHeader);
+    return TRUE;
 }
 
 /***********************************************************************
@@ -1149,7 +1219,8 @@ static BOOL urlcache_clean_leaked_entries(cache_container *container, urlcache_h
  * This function is meant to make place in index file by removing leaked
  * files entries and resizing the file.
  *
- * CAUTION: file view may get mapped to new memory
+ * CAUTION: file view may get mapped to new memory, it's unmapped and set
+ *          to NULL if the index couldn't be mapped again after resizing
  *
  * RETURNS
  *     ERROR_SUCCESS when new memory is available
@@ -1170,16 +1241,24 @@ static DWORD cache_container_clean_index(cache_container *container, urlcache_he
         return ERROR_NOT_ENOUGH_MEMORY;
     }
 
+    /* keep the old view usable by the caller until the new one is mapped */
+    AcquireSRWLockExclusive(&container->view_lock);
+    container->header = NULL;
+    ReleaseSRWLockExclusive(&container->view_lock);
     cache_container_close_index(container);
     ret = cache_container_open_index(container, header->capacity_in_blocks*2);
-    if(ret != ERROR_SUCCESS)
+    if(ret == ERROR_SUCCESS && !(header = MapViewOfFile(container->mapping, FILE_MAP_WRITE, 0, 0, 0)))
+        ret = GetLastError();
+    UnmapViewOfFile(*file_view);
+    if(ret != ERROR_SUCCESS) {
+        /* the next cache_container_lock_index call maps the index again */
+        *file_view = NULL;
         return ret;
-    header = MapViewOfFile(container->mapping, FILE_MAP_WRITE, 0, 0, 0);
-    if(!header)
-        return GetLastError();
+    }
 
-    UnmapViewOfFile(*file_view);
-    *file_view = header;
+    AcquireSRWLockExclusive(&container->view_lock);
+    *file_view = container->header = header;
+    ReleaseSRWLockExclusive(&container->view_lock);
     return ERROR_SUCCESS;
 }
 
@@ -1536,6 +1615,117 @@ static BOOL urlcache_find_hash_entry(const urlcache_header *pHeader, LPCSTR lpsz
     return FALSE;
 }
 
+/* part of the index header copied by cache_container_find_entry, only the
+ * directory data is needed to build the local file name of an entry */
+#define HEADER_SNAPSHOT_SIZE ((offsetof(urlcache_header, options) + 7) & ~7)
+
+/***********************************************************************
+ *           cache_container_find_entry (Internal)
+ *
+ *  Looks up the url entry without taking the container mutex. The hash
+ * tables and the entry are bounds-checked against the size of the mapped
+ * view and the entry is copied, the copy is only used if no process started
+ * modifying the index while it was read.
+ *
+ * RETURNS
+ *    ERROR_SUCCESS, *snapshot holds the header and entry copy, to be freed
+ *                   with heap_free
+ *    ERROR_FILE_NOT_FOUND if there's no entry for the url
+ *    ERROR_RETRY if the lookup has to be done with the index locked
+ *
+ */
+static DWORD cache_container_find_entry(cache_container *container, const char *url,
+        urlcache_header **snapshot, entry_url **url_entry)
+{
+    DWORD key = urlcache_hash_key(url);
+    DWORD bucket = (key & (HASHTABLE_NUM_ENTRIES-1)) * HASHTABLE_BLOCKSIZE;
+    const volatile LONG *sequence = container->sequence;
+    DWORD table_off, entry_off = 0, entry_size, file_size, id, i;
+    const entry_hash_table *table;
+    const urlcache_header *header;
+    const entry_url *entry;
+    DWORD ret = ERROR_RETRY;
+    LONG seq;
+    BYTE *copy;
+
+    if(!sequence)
+        return ERROR_RETRY;
+
+    key >>= HASHTABLE_FLAG_BITS;
+
+    AcquireSRWLockShared(&container->view_lock);
+    header = container->header;
+    file_size = container->file_size;
+    seq = *sequence;
+    MemoryBarrier();
+    if(!header || (seq & 1) || header->size != file_size)
+        goto done;
+
+    for(table_off = header->hash_table_off, id = 0; table_off; table_off = table->next, id++) {
+        if(table_off < ENTRY_START_OFFSET || table_off > file_size - sizeof(*table) ||
+                id > (file_size - ENTRY_START_OFFSET) / sizeof(*table))
+            goto done;
+
+        table = (const entry_hash_table*)((const BYTE*)header + table_off);
+        if(table->id != id || table->header.signature != HASH_SIGNATURE)
+            continue;
+
+        for(i = 0; i < HASHTABLE_BLOCKSIZE; i++) {
+            if(key == table->hash_table[bucket + i].key >> HASHTABLE_FLAG_BITS) {
+                entry_off = table->hash_table[bucket + i].offset;
+                break;
+            }
+        }
+        if(i < HASHTABLE_BLOCKSIZE)
+            break;
+    }
+
+    if(!table_off) {
+        MemoryBarrier();
+        if(*sequence == seq)
+            ret = ERROR_FILE_NOT_FOUND;
+        goto done;
+    }
+
+    if(entry_off < ENTRY_START_OFFSET || entry_off > file_size - sizeof(*entry))
+        goto done;
+    entry = (const entry_url*)((const BYTE*)header + entry_off);
+    entry_size = *(const volatile DWORD*)&entry->header.blocks_used;
+    if(entry->header.signature != URL_SIGNATURE || entry_size > (file_size - entry_off) / BLOCKSIZE)
+        goto done;
+    entry_size *= BLOCKSIZE;
+    if(entry_size < sizeof(*entry))
+        goto done;
+
+    if(!(copy = heap_alloc(HEADER_SNAPSHOT_SIZE + entry_size + 1)))
+        goto done;
+    memcpy(copy, header, HEADER_SNAPSHOT_SIZE);
+    memcpy(copy + HEADER_SNAPSHOT_SIZE, entry, entry_size);
+    copy[HEADER_SNAPSHOT_SIZE + entry_size] = 0;
+
+    MemoryBarrier();
+    if(*sequence != seq) {
+        heap_free(copy);
+        goto done;
+    }
+
+    /* the entry may still be broken, the strings are terminated by the extra byte */
+    *snapshot = (urlcache_header*)copy;
+    *url_entry = (entry_url*)(copy + HEADER_SNAPSHOT_SIZE);
+    if((*snapshot)->dirs_no > MAX_DIR_NO || !(*url_entry)->url_off || (*url_entry)->url_off >= entry_size ||
+            (*url_entry)->local_name_off >= entry_size || (*url_entry)->file_extension_off >= entry_size ||
+            (*url_entry)->header_info_off > entry_size ||
+            (*url_entry)->header_info_size > entry_size - (*url_entry)->header_info_off) {
+        heap_free(copy);
+        goto done;
+    }
+    ret = ERROR_SUCCESS;
+
+done:
+    ReleaseSRWLockShared(&container->view_lock);
+    return ret;
+}
+
 /***********************************************************************
  *           urlcache_hash_entry_set_flags (Internal)
  *
@@ -1754,12 +1944,38 @@ static BOOL urlcache_hash_entry_is_locked(struct hash_entry *hash_entry, entry_u
     return TRUE;
 }
 
+static DWORD urlcache_get_entry_info_copy(cache_container *container, const urlcache_header *header,
+        const entry_url *url_entry, void *entry_info, DWORD *size, DWORD flags, BOOL unicode)
+{
+    DWORD error;
+
+    TRACE("Found URL: %s\n", debugstr_a((LPCSTR)url_entry + url_entry->url_off));
+    TRACE("Header info: %s\n", debugstr_an((LPCSTR)url_entry +
+                url_entry->header_info_off, url_entry->header_info_size));
+
+    if((flags & GET_INSTALLED_ENTRY) && !(url_entry->cache_entry_type & INSTALLED_CACHE_ENTRY))
+        return ERROR_FILE_NOT_FOUND;
+
+    if(size) {
+        if(!entry_info)
+            *size = 0;
+
+        error = urlcache_copy_entry(container, header, entry_info, size, url_entry, unicode);
+        if(error != ERROR_SUCCESS)
+            return error;
+        if(url_entry->local_name_off)
+            TRACE("Local File Name: %s\n", debugstr_a((LPCSTR)url_entry + url_entry->local_name_off));
+    }
+
+    return ERROR_SUCCESS;
+}
+
 static BOOL urlcache_get_entry_info(const char *url, void *entry_info,
         DWORD *size, DWORD flags, BOOL unicode)
 {
     urlcache_header *header;
     struct hash_entry *hash_entry;
-    const entry_url *url_entry;
+    entry_url *url_entry;
     cache_container *container;
     DWORD error;
 
@@ -1774,56 +1990,42 @@ static BOOL urlcache_get_entry_info(const char *url, void *entry_info,
         return FALSE;
     }
 
-    error = cache_container_open_index(container, MIN_BLOCK_NO);
-    if(error != ERROR_SUCCESS) {
-        SetLastError(error);
-        return FALSE;
-    }
-
-    if(!(header = cache_container_lock_index(container)))
-        return FALSE;
+    error = cache_container_find_entry(container, url, &header, &url_entry);
+    if(error == ERROR_SUCCESS) {
+        error = urlcache_get_entry_info_copy(container, header, url_entry, entry_info, size, flags, unicode);
+        heap_free(header);
+    }else if(error == ERROR_RETRY) {
+        error = cache_container_open_index(container, MIN_BLOCK_NO);
+        if(error != ERROR_SUCCESS) {
+            SetLastError(error);
+            return FALSE;
+        }
 
-    if(!urlcache_find_hash_entry(header, url, &hash_entry)) {
-        cache_container_unlock_index(container, header);
-        WARN("entry %s not found!\n", debugstr_a(url));
-        SetLastError(ERROR_FILE_NOT_FOUND);
-        return FALSE;
-    }
+        if(!(header = cache_container_lock_index(container)))
+            return FALSE;
 
-    url_entry = (const entry_url*)((LPBYTE)header + hash_entry->offset);
-    if(url_entry->header.signature != URL_SIGNATURE) {
-        FIXME("Trying to retrieve entry of unknown format %s\n",
-                debugstr_an((LPCSTR)&url_entry->header.signature, sizeof(DWORD)));
+        if(!urlcache_find_hash_entry(header, url, &hash_entry)) {
+            error = ERROR_FILE_NOT_FOUND;
+        }else {
+            url_entry = (entry_url*)((LPBYTE)header + hash_entry->offset);
+            if(url_entry->header.signature != URL_SIGNATURE) {
+                FIXME("Trying to retrieve entry of unknown format %s\n",
+                        debugstr_an((LPCSTR)&url_entry->header.signature, sizeof(DWORD)));
+                error = ERROR_FILE_NOT_FOUND;
+            }else {
+                error = urlcache_get_entry_info_copy(container, header, url_entry,
+                        entry_info, size, flags, unicode);
+            }
+        }
         cache_container_unlock_index(container, header);
-        SetLastError(ERROR_FILE_NOT_FOUND);
-        return FALSE;
     }
 
-    TRACE("Found URL: %s\n", debugstr_a((LPCSTR)url_entry + url_entry->url_off));
-    TRACE("Header info: %s\n", debugstr_an((LPCSTR)url_entry +
-                url_entry->header_info_off, url_entry->header_info_size));
-
-    if((flags & GET_INSTALLED_ENTRY) && !(url_entry->cache_entry_type & INSTALLED_CACHE_ENTRY)) {
-        cache_container_unlock_index(container, header);
-        SetLastError(ERROR_FILE_NOT_FOUND);
+    if(error != ERROR_SUCCESS) {
+        if(error == ERROR_FILE_NOT_FOUND)
+            WARN("entry %s not found!\n", debugstr_a(url));
+        SetLastError(error);
         return FALSE;
     }
-
-    if(size) {
-        if(!entry_info)
-            *size = 0;
-
-        error = urlcache_copy_entry(container, header, entry_info, size, url_entry, unicode);
-        if(error != ERROR_SUCCESS) {
-            cache_container_unlock_index(container, header);
-            SetLastError(error);
-            return FALSE;
-        }
-        if(url_entry->local_name_off)
-            TRACE("Local File Name: %s\n", debugstr_a((LPCSTR)url_entry + url_entry->local_name_off));
-    }
-
-    cache_container_unlock_index(container, header);
     return TRUE;
 }
 
@@ -2367,12 +2569,14 @@ BOOL WINAPI FreeUrlCacheSpaceW(LPCWSTR cache_path, DWORD size, DWORD filter)
                 BOOL ret_del;
 
                 WaitForSingleObject(container->mutex, INFINITE);
+                cache_container_begin_write(container);
 
                 /* unlock, delete, recreate and lock cache */
                 cache_container_close_index(container);
                 ret_del = cache_container_delete_dir(container->path);
                 err = cache_container_open_index(container, MIN_BLOCK_NO);
 
+                cache_container_end_write(container);
                 ReleaseMutex(container->mutex);
                 if(!ret_del || (err != ERROR_SUCCESS))
                     return FALSE;
@@ -3003,7 +3207,8 @@ static BOOL urlcache_entry_commit(const char *url, const WCHAR *file_name,
         }
     }
     if(error != ERROR_SUCCESS) {
-        urlcache_entry_free(header, &url_entry->header);
+        if(header)
+            urlcache_entry_free(header, &url_entry->header);
         cache_container_unlock_index(container, header);
         SetLastError(error);
         return FALSE;
@@ -3946,6 +4151,7 @@ BOOL WINAPI IsUrlCacheEntryExpiredA(LPCSTR url, DWORD dwFlags, FILETIME* pftLast
     struct hash_entry *pHashEntry;
     const entry_header *pEntry;
     const entry_url * pUrlEntry;
+    entry_url *pSnapshot;
     cache_container *pContainer;
     BOOL expired;
 
@@ -3963,6 +4169,18 @@ BOOL WINAPI IsUrlCacheEntryExpiredA(LPCSTR url, DWORD dwFlags, FILETIME* pftLast
         return TRUE;
     }
 
+    switch (cache_container_find_entry(pContainer, url, &pHeader, &pSnapshot))
+    {
+    case ERROR_SUCCESS:
+        expired = urlcache_entry_is_expired(pSnapshot, pftLastModified);
+        heap_free(pHeader);
+        return expired;
+    case ERROR_FILE_NOT_FOUND:
+        memset(pftLastModified, 0, sizeof(*pftLastModified));
+        TRACE("entry %s not found!\n", url);
+        return TRUE;
+    }
+
     if (cache_container_open_index(pContainer, MIN_BLOCK_NO))
     {
         memset(pftLastModified, 0, sizeof(*pftLastModified));
@@ -873,6 +873,88 @@ static BOOL WINAPI WS2_TransmitFile( SOCKET s, HANDLE file, DWORD file_len, DWOR
 }
 
 
+static BOOL WINAPI WS2_TransmitPackets( SOCKET s, TRANSMIT_PACKETS_ELEMENT *elements, DWORD count,
+                                        DWORD send_size, OVERLAPPED *overlapped, DWORD flags )
+{
+    struct afd_transmit_packets_element *afd_elements;
+    struct afd_transmit_packets_params *params;
+    IO_STATUS_BLOCK iosb, *piosb = &iosb;
+    HANDLE event = NULL;
+    void *cvalue = NULL;
+    NTSTATUS status;
+    DWORD size, i;
+
+    TRACE( "socket %#Ix, elements %p, count %lu, send_size %lu, overlapped %p, flags %#lx\n",
+           s, elements, count, send_size, overlapped, flags );
+
+    if (count && !elements)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    size = sizeof(*params) + count * sizeof(*afd_elements);
+    if (!(params = malloc( size )))
+    {
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    afd_elements = (struct afd_transmit_packets_element *)(params + 1);
+
+    params->count = count;
+    params->send_size = send_size;
+    params->flags = flags;
+    params->__pad = 0;
+    for (i = 0; i < count; ++i)
+    {
+        afd_elements[i].flags = elements[i].dwElFlags;
+        afd_elements[i].len = elements[i].cLength;
+        afd_elements[i].__pad = 0;
+        if (elements[i].dwElFlags & TP_ELEMENT_FILE)
+        {
+            afd_elements[i].offset = elements[i].u.s.nFileOffset;
+            afd_elements[i].file = HandleToULong( elements[i].u.s.hFile );
+            afd_elements[i].buffer_ptr = 0;
+        }
+        else
+        {
+            afd_elements[i].offset.QuadPart = 0;
+            afd_elements[i].file = 0;
+            afd_elements[i].buffer_ptr = u64_from_user_ptr( elements[i].u.pBuffer );
+        }
+    }
+
+    if (overlapped)
+    {
+        piosb = (IO_STATUS_BLOCK *)overlapped;
+        if (!((ULONG_PTR)overlapped->hEvent & 1)) cvalue = overlapped;
+        event = overlapped->hEvent;
+        overlapped->Internal = STATUS_PENDING;
+        overlapped->InternalHigh = 0;
+    }
+    else if (!(event = get_sync_event()))
+    {
+        free( params );
+        return FALSE;
+    }
+
+    /* The element array is copied by the ioctl, so it can be freed right away;
+     * only the memory buffers it points to must stay valid. */
+    status = NtDeviceIoControlFile( (HANDLE)s, event, NULL, cvalue, piosb,
+                                    IOCTL_AFD_WINE_TRANSMIT_PACKETS, params, size, NULL, 0 );
+    free( params );
+    if (status == STATUS_PENDING && !overlapped)
+    {
+        if (WaitForSingleObject( event, INFINITE ) == WAIT_FAILED)
+            return FALSE;
+        status = piosb->u.Status;
+    }
+    SetLastError( NtStatusToWSAError( status ) );
+    TRACE( "status %#lx.\n", status );
+    return !status;
+}
+
+
 /***********************************************************************
  *     GetAcceptExSockaddrs
  */
@@ -2247,7 +2329,7 @@ INT WINAPI WSAIoctl(SOCKET s, DWORD code, LPVOID in_buff, DWORD in_size, LPVOID
             EXTENSION_FUNCTION(WSAID_ACCEPTEX, WS2_AcceptEx)
             EXTENSION_FUNCTION(WSAID_GETACCEPTEXSOCKADDRS, WS2_GetAcceptExSockaddrs)
             EXTENSION_FUNCTION(WSAID_TRANSMITFILE, WS2_TransmitFile)
-            /* EXTENSION_FUNCTION(WSAID_TRANSMITPACKETS, WS2_TransmitPackets) */
+            EXTENSION_FUNCTION(WSAID_TRANSMITPACKETS, WS2_TransmitPackets)
             EXTENSION_FUNCTION(WSAID_WSARECVMSG, WS2_WSARecvMsg)
             EXTENSION_FUNCTION(WSAID_WSASENDMSG, WSASendMsg)
         };
@@ -8625,6 +8625,75 @@ static void test_TransmitFile(void)
     closesocket(server);
 }
 
+static void test_TransmitPackets(void)
+{
+    GUID transmit_packets_guid = WSAID_TRANSMITPACKETS;
+    LPFN_TRANSMITPACKETS pTransmitPackets = NULL;
+    char header_msg[] = "hello world";
+    char footer_msg[] = "goodbye!!!";
+    TRANSMIT_PACKETS_ELEMENT elements[3];
+    char system_ini_path[MAX_PATH];
+    DWORD size, file_size, sent;
+    SOCKET client, server;
+    OVERLAPPED overlapped;
+    char buf[256];
+    HANDLE file;
+    int ret;
+
+    tcp_socketpair(&client, &server);
+
+    ret = WSAIoctl(client, SIO_GET_EXTENSION_FUNCTION_POINTER, &transmit_packets_guid, sizeof(transmit_packets_guid),
+            &pTransmitPackets, sizeof(pTransmitPackets), &size, NULL, NULL);
+    ok(!ret, "failed to get TransmitPackets, error %u\n", WSAGetLastError());
+
+    GetSystemWindowsDirectoryA(system_ini_path, MAX_PATH);
+    strcat(system_ini_path, "\\system.ini");
+    file = CreateFileA(system_ini_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_ALWAYS, 0, NULL);
+    ok(file != INVALID_HANDLE_VALUE, "failed to open file, error %lu\n", GetLastError());
+    file_size = GetFileSize(file, NULL);
+
+    memset(elements, 0, sizeof(elements));
+    elements[0].dwElFlags = TP_ELEMENT_MEMORY;
+    elements[0].cLength = sizeof(header_msg);
+    elements[0].pBuffer = header_msg;
+    elements[1].dwElFlags = TP_ELEMENT_FILE;
+    elements[1].cLength = 0;
+    elements[1].nFileOffset.QuadPart = 0;
+    elements[1].hFile = file;
+    elements[2].dwElFlags = TP_ELEMENT_MEMORY | TP_ELEMENT_EOP;
+    elements[2].cLength = sizeof(footer_msg);
+    elements[2].pBuffer = footer_msg;
+
+    ret = pTransmitPackets(client, elements, ARRAY_SIZE(elements), 0, NULL, 0);
+    ok(ret, "TransmitPackets failed, error %u\n", WSAGetLastError());
+    ret = recv(server, buf, sizeof(header_msg), 0);
+    ok(ret == sizeof(header_msg), "got %d\n", ret);
+    ok(!memcmp(buf, header_msg, sizeof(header_msg)), "header didn't match\n");
+    compare_file(file, server, 0);
+    ret = recv(server, buf, sizeof(footer_msg), 0);
+    ok(ret == sizeof(footer_msg), "got %d\n", ret);
+    ok(!memcmp(buf, footer_msg, sizeof(footer_msg)), "footer didn't match\n");
+
+    /* Part of the file, asynchronously. */
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    elements[1].cLength = file_size / 2;
+    elements[1].nFileOffset.QuadPart = file_size - file_size / 2;
+    ret = pTransmitPackets(client, &elements[1], 1, 0, &overlapped, 0);
+    ok(ret || WSAGetLastError() == ERROR_IO_PENDING, "TransmitPackets failed, error %u\n", WSAGetLastError());
+    ret = WaitForSingleObject(overlapped.hEvent, 2000);
+    ok(!ret, "got %d\n", ret);
+    ret = WSAGetOverlappedResult(client, &overlapped, &sent, FALSE, &size);
+    ok(ret, "got error %u\n", WSAGetLastError());
+    ok(sent == file_size / 2, "expected %lu bytes, got %lu\n", file_size / 2, sent);
+    compare_file(file, server, file_size - file_size / 2);
+
+    CloseHandle(overlapped.hEvent);
+    CloseHandle(file);
+    closesocket(client);
+    closesocket(server);
+}
+
 static void test_getpeername(void)
 {
     SOCKET sock;
@@ -11811,6 +11880,89 @@ static void test_simultaneous_async_recv(void)
     for (i = 0; i < num_io; i++) CloseHandle(events[i]);
 }
 
+static void test_simultaneous_async_recv_udp(void)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    OVERLAPPED overlappeds[8] = {{0}};
+    HANDLE events[ARRAY_SIZE(overlappeds)];
+    DWORD flags[ARRAY_SIZE(overlappeds)] = {0};
+    char bufs[ARRAY_SIZE(overlappeds)][8];
+    WSABUF wsabufs[ARRAY_SIZE(overlappeds)];
+    SOCKET client, server;
+    int ret, len = sizeof(addr);
+    char msg[8];
+    DWORD size;
+    size_t i;
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ret = bind(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = getsockname(client, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        events[i] = CreateEventW(NULL, TRUE, FALSE, NULL);
+        overlappeds[i].hEvent = events[i];
+        wsabufs[i].buf = bufs[i];
+        wsabufs[i].len = sizeof(bufs[i]);
+        ret = WSARecvFrom(client, &wsabufs[i], 1, NULL, &flags[i], NULL, NULL, &overlappeds[i], NULL);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u\n", WSAGetLastError());
+    }
+
+    /* send a burst of datagrams; each one should complete exactly one pending
+     * request, in the order the requests were queued */
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        sprintf(msg, "dgram%u", (unsigned int)i);
+        ret = sendto(server, msg, strlen(msg) + 1, 0, (struct sockaddr *)&addr, sizeof(addr));
+        ok(ret == strlen(msg) + 1, "got %d\n", ret);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        winetest_push_context("%u", (unsigned int)i);
+        ret = WaitForSingleObject(events[i], 1000);
+        ok(!ret, "wait timed out\n");
+        size = 0;
+        ret = GetOverlappedResult((HANDLE)client, &overlappeds[i], &size, FALSE);
+        ok(ret, "got error %lu\n", GetLastError());
+        sprintf(msg, "dgram%u", (unsigned int)i);
+        ok(size == strlen(msg) + 1, "got size %lu\n", size);
+        ok(!strcmp(bufs[i], msg), "got %s\n", debugstr_an(bufs[i], size));
+        winetest_pop_context();
+    }
+
+    /* a single datagram completes only the first of several pending requests */
+    for (i = 0; i < 2; i++)
+    {
+        ResetEvent(events[i]);
+        ret = WSARecvFrom(client, &wsabufs[i], 1, NULL, &flags[i], NULL, NULL, &overlappeds[i], NULL);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u\n", WSAGetLastError());
+    }
+
+    ret = sendto(server, "single", 7, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 7, "got %d\n", ret);
+    ret = WaitForSingleObject(events[0], 1000);
+    ok(!ret, "wait timed out\n");
+    ret = WaitForSingleObject(events[1], 100);
+    ok(ret == WAIT_TIMEOUT, "got %d\n", ret);
+
+    ret = sendto(server, "second", 7, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 7, "got %d\n", ret);
+    ret = WaitForSingleObject(events[1], 1000);
+    ok(!ret, "wait timed out\n");
+    ok(!strcmp(bufs[1], "second"), "got %s\n", debugstr_an(bufs[1], sizeof(bufs[1])));
+
+    closesocket(client);
+    closesocket(server);
+
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++) CloseHandle(events[i]);
+}
+
 static void test_empty_recv(void)
 {
     OVERLAPPED overlapped = {0};
@@ -12357,6 +12509,7 @@ START_TEST( sock )
 
     test_ipv6only();
     test_TransmitFile();
+    test_TransmitPackets();
     test_AcceptEx();
     test_connect();
     test_shutdown();
@@ -12370,6 +12523,7 @@ START_TEST( sock )
     test_WSAGetOverlappedResult();
     test_nonblocking_async_recv();
     test_simultaneous_async_recv();
+    test_simultaneous_async_recv_udp();
     test_empty_recv();
     test_timeout();
 
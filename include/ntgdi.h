@@ -160,6 +160,30 @@ enum
 /* structs not compatible with native Windows */
 #ifdef __WINESRC__
 
+/* drawing commands recorded by gdi32 when batching is enabled with GdiSetBatchLimit */
+#define DC_BATCH_SIZE 32
+
+enum
+{
+    NTGDI_BATCH_PATBLT,
+    NTGDI_BATCH_RECTANGLE,
+    NTGDI_BATCH_LINETO,
+};
+
+struct dc_batch_entry
+{
+    UINT type;
+    INT  args[5];
+};
+
+/* per-thread buffer of batched commands, only used by the thread that recorded them */
+struct dc_batch
+{
+    HDC   hdc;                     /* DC the pending commands are for */
+    UINT  count;                   /* number of pending commands */
+    struct dc_batch_entry entries[DC_BATCH_SIZE];
+};
+
 typedef struct DC_ATTR
 {
     HDC       hdc;                 /* handle to self */
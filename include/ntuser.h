@@ -55,6 +55,8 @@ struct ntuser_thread_info
     ULONG_PTR  message_extra;     /* value for GetMessageExtraInfo */
     HWND       top_window;        /* desktop window */
     HWND       msg_window;        /* HWND_MESSAGE parent window */
+    struct dc_batch *gdi_batch;   /* GDI commands batched by gdi32, executed by NtGdiFlush */
+    DWORD      batch_limit;       /* GDI batch limit, 0 for default */
 };
 
 static inline struct ntuser_thread_info *NtUserGetThreadInfo(void)
@@ -283,6 +283,7 @@ C_ASSERT( sizeof(struct afd_get_events_params) == 56 );
 #define IOCTL_AFD_WINE_SET_IP_RECVTTL                   WINE_AFD_IOC(294)
 #define IOCTL_AFD_WINE_GET_IP_RECVTOS                   WINE_AFD_IOC(295)
 #define IOCTL_AFD_WINE_SET_IP_RECVTOS                   WINE_AFD_IOC(296)
+#define IOCTL_AFD_WINE_TRANSMIT_PACKETS                 WINE_AFD_IOC(297)
 
 struct afd_iovec
 {
@@ -350,6 +351,27 @@ struct afd_transmit_params
 };
 C_ASSERT( sizeof(struct afd_transmit_params) == 48 );
 
+struct afd_transmit_packets_element
+{
+    LARGE_INTEGER offset;
+    ULONGLONG buffer_ptr;
+    DWORD flags;
+    DWORD len;
+    ULONG file;
+    DWORD __pad;
+};
+C_ASSERT( sizeof(struct afd_transmit_packets_element) == 32 );
+
+struct afd_transmit_packets_params
+{
+    unsigned int count;
+    DWORD send_size;
+    DWORD flags;
+    DWORD __pad;
+    /* VARARG(elements, struct afd_transmit_packets_element, count); */
+};
+C_ASSERT( sizeof(struct afd_transmit_packets_params) == 16 );
+
 struct afd_message_select_params
 {
     ULONG handle;
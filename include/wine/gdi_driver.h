@@ -165,7 +165,7 @@ struct gdi_dc_funcs
 };
 
 /* increment this when you change the DC function table */
-#define WINE_GDI_DRIVER_VERSION 77
+#define WINE_GDI_DRIVER_VERSION 78
 
 #define GDI_PRIORITY_NULL_DRV        0  /* null driver */
 #define GDI_PRIORITY_FONT_DRV      100  /* any font driver */
@@ -208,12 +208,17 @@ struct window_surface_funcs
     void  (*destroy)( struct window_surface *surface );
 };
 
+#define WINDOW_SURFACE_MAX_DAMAGE 8
+#define WINDOW_SURFACE_DAMAGE_INVALID (~0u)  /* damage not tracked until the next flush */
+
 struct window_surface
 {
     const struct window_surface_funcs *funcs; /* driver-specific implementations  */
     struct list                        entry; /* entry in global list managed by user32 */
     LONG                               ref;   /* reference count */
     RECT                               rect;  /* constant, no locking needed */
+    UINT                               damage_count; /* number of damaged rects or WINDOW_SURFACE_DAMAGE_INVALID, protected by the surface lock */
+    RECT                               damage[WINDOW_SURFACE_MAX_DAMAGE]; /* disjoint damaged rects, relative to rect */
     /* driver-specific fields here */
 };
 
@@ -229,6 +234,48 @@ static inline ULONG window_surface_release( struct window_surface *surface )
     return ret;
 }
 
+/* Retrieve the rectangles that need to be flushed. The damage list is only a refinement
+ * of the driver bounds, so if the bounds have been extended without going through it we
+ * fall back to the bounds. Must be called with the surface locked. */
+static inline UINT window_surface_get_damage( struct window_surface *surface, const RECT *bounds, RECT *rects )
+{
+    RECT total;
+    UINT i;
+
+    if (bounds->left >= bounds->right || bounds->top >= bounds->bottom) return 0;
+    if (surface->damage_count && surface->damage_count <= WINDOW_SURFACE_MAX_DAMAGE)
+    {
+        total = surface->damage[0];
+        for (i = 1; i < surface->damage_count; i++)
+        {
+            if (surface->damage[i].left < total.left) total.left = surface->damage[i].left;
+            if (surface->damage[i].top < total.top) total.top = surface->damage[i].top;
+            if (surface->damage[i].right > total.right) total.right = surface->damage[i].right;
+            if (surface->damage[i].bottom > total.bottom) total.bottom = surface->damage[i].bottom;
+        }
+        if (total.left == bounds->left && total.top == bounds->top &&
+            total.right == bounds->right && total.bottom == bounds->bottom)
+        {
+            for (i = 0; i < surface->damage_count; i++) rects[i] = surface->damage[i];
+            return surface->damage_count;
+        }
+    }
+    rects[0] = *bounds;
+    return 1;
+}
+
+static inline void window_surface_reset_damage( struct window_surface *surface )
+{
+    surface->damage_count = 0;
+}
+
+/* Must be called when the driver bounds are extended without adding the same area to
+ * the damage list, so that the next flush covers the whole bounds. */
+static inline void window_surface_invalidate_damage( struct window_surface *surface )
+{
+    surface->damage_count = WINDOW_SURFACE_DAMAGE_INVALID;
+}
+
 /* display manager interface, used to initialize display device registry data */
 
 struct gdi_gpu
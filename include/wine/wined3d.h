@@ -2266,6 +2266,9 @@ struct wined3d_streaming_buffer
     struct wined3d_buffer *buffer;
     unsigned int pos;
     unsigned int bind_flags;
+    unsigned int upload_count;
+    unsigned int wrap_count;
+    UINT64 bytes_streamed;
 };
 
 void __stdcall wined3d_mutex_lock(void);
@@ -626,7 +626,7 @@ struct hlsl_ir_store *hlsl_new_store(struct hlsl_ctx *ctx, struct hlsl_ir_var *v
     if (!writemask && type_is_single_reg(rhs->data_type))
         writemask = (1 << rhs->data_type->dimx) - 1;
 
-    if (!(store = hlsl_alloc(ctx, sizeof(*store))))
+    if (!(store = hlsl_alloc_node(ctx, sizeof(*store))))
         return NULL;
 
     init_node(&store->node, HLSL_IR_STORE, NULL, loc);
@@ -649,7 +649,7 @@ struct hlsl_ir_constant *hlsl_new_constant(struct hlsl_ctx *ctx, struct hlsl_typ
 
     assert(type->type <= HLSL_CLASS_VECTOR);
 
-    if (!(c = hlsl_alloc(ctx, sizeof(*c))))
+    if (!(c = hlsl_alloc_node(ctx, sizeof(*c))))
         return NULL;
 
     init_node(&c->node, HLSL_IR_CONSTANT, type, *loc);
@@ -688,7 +688,7 @@ struct hlsl_ir_node *hlsl_new_unary_expr(struct hlsl_ctx *ctx, enum hlsl_ir_expr
 {
     struct hlsl_ir_expr *expr;
 
-    if (!(expr = hlsl_alloc(ctx, sizeof(*expr))))
+    if (!(expr = hlsl_alloc_node(ctx, sizeof(*expr))))
         return NULL;
     init_node(&expr->node, HLSL_IR_EXPR, arg->data_type, loc);
     expr->op = op;
@@ -703,7 +703,7 @@ struct hlsl_ir_node *hlsl_new_binary_expr(struct hlsl_ctx *ctx, enum hlsl_ir_exp
 
     assert(hlsl_types_are_equal(arg1->data_type, arg2->data_type));
 
-    if (!(expr = hlsl_alloc(ctx, sizeof(*expr))))
+    if (!(expr = hlsl_alloc_node(ctx, sizeof(*expr))))
         return NULL;
     init_node(&expr->node, HLSL_IR_EXPR, arg1->data_type, arg1->loc);
     expr->op = op;
@@ -716,7 +716,7 @@ struct hlsl_ir_if *hlsl_new_if(struct hlsl_ctx *ctx, struct hlsl_ir_node *condit
 {
     struct hlsl_ir_if *iff;
 
-    if (!(iff = hlsl_alloc(ctx, sizeof(*iff))))
+    if (!(iff = hlsl_alloc_node(ctx, sizeof(*iff))))
         return NULL;
     init_node(&iff->node, HLSL_IR_IF, NULL, loc);
     hlsl_src_from_node(&iff->condition, condition);
@@ -730,7 +730,7 @@ struct hlsl_ir_load *hlsl_new_load(struct hlsl_ctx *ctx, struct hlsl_ir_var *var
 {
     struct hlsl_ir_load *load;
 
-    if (!(load = hlsl_alloc(ctx, sizeof(*load))))
+    if (!(load = hlsl_alloc_node(ctx, sizeof(*load))))
         return NULL;
     init_node(&load->node, HLSL_IR_LOAD, type, loc);
     load->src.var = var;
@@ -751,7 +751,7 @@ struct hlsl_ir_resource_load *hlsl_new_resource_load(struct hlsl_ctx *ctx, struc
 {
     struct hlsl_ir_resource_load *load;
 
-    if (!(load = hlsl_alloc(ctx, sizeof(*load))))
+    if (!(load = hlsl_alloc_node(ctx, sizeof(*load))))
         return NULL;
     init_node(&load->node, HLSL_IR_RESOURCE_LOAD, data_type, *loc);
     load->load_type = type;
@@ -769,7 +769,7 @@ struct hlsl_ir_swizzle *hlsl_new_swizzle(struct hlsl_ctx *ctx, DWORD s, unsigned
 {
     struct hlsl_ir_swizzle *swizzle;
 
-    if (!(swizzle = hlsl_alloc(ctx, sizeof(*swizzle))))
+    if (!(swizzle = hlsl_alloc_node(ctx, sizeof(*swizzle))))
         return NULL;
     init_node(&swizzle->node, HLSL_IR_SWIZZLE,
             hlsl_get_vector_type(ctx, val->data_type->base_type, components), *loc);
@@ -782,7 +782,7 @@ struct hlsl_ir_jump *hlsl_new_jump(struct hlsl_ctx *ctx, enum hlsl_ir_jump_type
 {
     struct hlsl_ir_jump *jump;
 
-    if (!(jump = hlsl_alloc(ctx, sizeof(*jump))))
+    if (!(jump = hlsl_alloc_node(ctx, sizeof(*jump))))
         return NULL;
     init_node(&jump->node, HLSL_IR_JUMP, NULL, loc);
     jump->type = type;
@@ -793,7 +793,7 @@ struct hlsl_ir_loop *hlsl_new_loop(struct hlsl_ctx *ctx, struct vkd3d_shader_loc
 {
     struct hlsl_ir_loop *loop;
 
-    if (!(loop = hlsl_alloc(ctx, sizeof(*loop))))
+    if (!(loop = hlsl_alloc_node(ctx, sizeof(*loop))))
         return NULL;
     init_node(&loop->node, HLSL_IR_LOOP, NULL, loc);
     list_init(&loop->body.instrs);
@@ -1503,6 +1503,58 @@ void hlsl_dump_function(struct hlsl_ctx *ctx, const struct hlsl_ir_function_decl
     vkd3d_string_buffer_cleanup(&buffer);
 }
 
+#define HLSL_NODE_ARENA_CHUNK_SIZE 0x10000u
+#define HLSL_NODE_ARENA_ALIGNMENT 16
+
+struct hlsl_node_arena_chunk
+{
+    struct hlsl_node_arena_chunk *next;
+};
+
+void *hlsl_alloc_node(struct hlsl_ctx *ctx, size_t size)
+{
+    size_t header_size = align(sizeof(struct hlsl_node_arena_chunk), HLSL_NODE_ARENA_ALIGNMENT);
+    struct hlsl_node_arena *arena = &ctx->node_arena;
+    struct hlsl_node_arena_chunk *chunk;
+    size_t chunk_size;
+    void *ptr;
+
+    size = align(size, HLSL_NODE_ARENA_ALIGNMENT);
+
+    if (!arena->chunks || arena->size - arena->offset < size)
+    {
+        chunk_size = max(HLSL_NODE_ARENA_CHUNK_SIZE, header_size + size);
+        if (!(chunk = vkd3d_malloc(chunk_size)))
+        {
+            ctx->result = VKD3D_ERROR_OUT_OF_MEMORY;
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->offset = header_size;
+        arena->size = chunk_size;
+        arena->total_size += chunk_size;
+    }
+
+    ptr = (char *)arena->chunks + arena->offset;
+    arena->offset += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+static void hlsl_node_arena_cleanup(struct hlsl_node_arena *arena)
+{
+    struct hlsl_node_arena_chunk *chunk, *next;
+
+    TRACE("Allocated %zu bytes for IR nodes.\n", arena->total_size);
+
+    for (chunk = arena->chunks; chunk; chunk = next)
+    {
+        next = chunk->next;
+        vkd3d_free(chunk);
+    }
+}
+
 void hlsl_replace_node(struct hlsl_ir_node *old, struct hlsl_ir_node *new)
 {
     struct hlsl_src *src, *next;
@@ -1546,18 +1598,12 @@ void hlsl_free_instr_list(struct list *list)
         hlsl_free_instr(node);
 }
 
-static void free_ir_constant(struct hlsl_ir_constant *constant)
-{
-    vkd3d_free(constant);
-}
-
 static void free_ir_expr(struct hlsl_ir_expr *expr)
 {
     unsigned int i;
 
     for (i = 0; i < ARRAY_SIZE(expr->operands); ++i)
         hlsl_src_remove(&expr->operands[i]);
-    vkd3d_free(expr);
 }
 
 static void free_ir_if(struct hlsl_ir_if *if_node)
@@ -1565,24 +1611,16 @@ static void free_ir_if(struct hlsl_ir_if *if_node)
     hlsl_free_instr_list(&if_node->then_instrs.instrs);
     hlsl_free_instr_list(&if_node->else_instrs.instrs);
     hlsl_src_remove(&if_node->condition);
-    vkd3d_free(if_node);
-}
-
-static void free_ir_jump(struct hlsl_ir_jump *jump)
-{
-    vkd3d_free(jump);
 }
 
 static void free_ir_load(struct hlsl_ir_load *load)
 {
     hlsl_src_remove(&load->src.offset);
-    vkd3d_free(load);
 }
 
 static void free_ir_loop(struct hlsl_ir_loop *loop)
 {
     hlsl_free_instr_list(&loop->body.instrs);
-    vkd3d_free(loop);
 }
 
 static void free_ir_resource_load(struct hlsl_ir_resource_load *load)
@@ -1591,22 +1629,21 @@ static void free_ir_resource_load(struct hlsl_ir_resource_load *load)
     hlsl_src_remove(&load->sampler.offset);
     hlsl_src_remove(&load->resource.offset);
     hlsl_src_remove(&load->texel_offset);
-    vkd3d_free(load);
 }
 
 static void free_ir_store(struct hlsl_ir_store *store)
 {
     hlsl_src_remove(&store->rhs);
     hlsl_src_remove(&store->lhs.offset);
-    vkd3d_free(store);
 }
 
 static void free_ir_swizzle(struct hlsl_ir_swizzle *swizzle)
 {
     hlsl_src_remove(&swizzle->val);
-    vkd3d_free(swizzle);
 }
 
+/* Releases the resources referenced by an instruction. The instruction itself
+ * is owned by the context's node arena. */
 void hlsl_free_instr(struct hlsl_ir_node *node)
 {
     assert(list_empty(&node->uses));
@@ -1614,7 +1651,7 @@ void hlsl_free_instr(struct hlsl_ir_node *node)
     switch (node->type)
     {
         case HLSL_IR_CONSTANT:
-            free_ir_constant(hlsl_ir_constant(node));
+        case HLSL_IR_JUMP:
             break;
 
         case HLSL_IR_EXPR:
@@ -1625,10 +1662,6 @@ void hlsl_free_instr(struct hlsl_ir_node *node)
             free_ir_if(hlsl_ir_if(node));
             break;
 
-        case HLSL_IR_JUMP:
-            free_ir_jump(hlsl_ir_jump(node));
-            break;
-
         case HLSL_IR_LOAD:
             free_ir_load(hlsl_ir_load(node));
             break;
@@ -2052,6 +2085,8 @@ static void hlsl_ctx_cleanup(struct hlsl_ctx *ctx)
         vkd3d_free((void *)buffer->name);
         vkd3d_free(buffer);
     }
+
+    hlsl_node_arena_cleanup(&ctx->node_arena);
 }
 
 int hlsl_compile_shader(const struct vkd3d_shader_code *hlsl, const struct vkd3d_shader_compile_info *compile_info,
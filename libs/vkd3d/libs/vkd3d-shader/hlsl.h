@@ -507,6 +507,15 @@ struct hlsl_ctx
     } constant_defs;
     uint32_t temp_count;
 
+    /* IR nodes are allocated from chunks owned by the context, and are only
+     * released when the context is destroyed. */
+    struct hlsl_node_arena
+    {
+        struct hlsl_node_arena_chunk *chunks;
+        size_t offset, size;
+        size_t total_size;
+    } node_arena;
+
     uint32_t in_state_block : 1;
 };
 
@@ -604,6 +613,8 @@ static inline void *hlsl_alloc(struct hlsl_ctx *ctx, size_t size)
     return ptr;
 }
 
+void *hlsl_alloc_node(struct hlsl_ctx *ctx, size_t size);
+
 static inline void *hlsl_realloc(struct hlsl_ctx *ctx, void *ptr, size_t size)
 {
     void *ret = vkd3d_realloc(ptr, size);
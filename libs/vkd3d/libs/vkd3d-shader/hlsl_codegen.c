@@ -1891,12 +1891,68 @@ struct hlsl_reg hlsl_reg_from_deref(struct hlsl_ctx *ctx, const struct hlsl_dere
     return ret;
 }
 
+struct hlsl_pass
+{
+    const char *name;
+    /* Exactly one of these is set. */
+    bool (*instr_func)(struct hlsl_ctx *ctx, struct hlsl_ir_node *instr, void *context);
+    bool (*block_func)(struct hlsl_ctx *ctx, struct hlsl_block *block);
+};
+
+/* Run a set of passes until none of them makes progress. Rather than running
+ * every pass again whenever any of them made progress, a pass is skipped if
+ * the IR hasn't changed since it last ran. Changes made by a pass itself
+ * count, since a pass isn't necessarily idempotent. */
+static void run_passes(struct hlsl_ctx *ctx, struct hlsl_block *block,
+        const struct hlsl_pass *passes, unsigned int pass_count)
+{
+    unsigned int i, change_count = 1, last_run[4] = {0};
+    bool progress, ran;
+
+    assert(pass_count <= ARRAY_SIZE(last_run));
+
+    do
+    {
+        ran = false;
+        for (i = 0; i < pass_count; ++i)
+        {
+            if (last_run[i] == change_count)
+                continue;
+            last_run[i] = change_count;
+            ran = true;
+
+            if (passes[i].block_func)
+                progress = passes[i].block_func(ctx, block);
+            else
+                progress = transform_ir(ctx, passes[i].instr_func, block, NULL);
+
+            if (progress)
+            {
+                TRACE("Pass %s made progress.\n", passes[i].name);
+                ++change_count;
+            }
+        }
+    }
+    while (ran);
+}
+
 int hlsl_emit_bytecode(struct hlsl_ctx *ctx, struct hlsl_ir_function_decl *entry_func,
         enum vkd3d_shader_target_type target_type, struct vkd3d_shader_code *out)
 {
     struct hlsl_block *const body = &entry_func->body;
     struct hlsl_ir_var *var;
-    bool progress;
+
+    static const struct hlsl_pass split_copy_passes[] =
+    {
+        {"split_array_copies", split_array_copies},
+        {"split_struct_copies", split_struct_copies},
+    };
+    static const struct hlsl_pass simplify_passes[] =
+    {
+        {"fold_constants", hlsl_fold_constants},
+        {"copy_propagation", NULL, copy_propagation_execute},
+        {"remove_trivial_swizzles", remove_trivial_swizzles},
+    };
 
     list_move_head(&body->instrs, &ctx->static_initializers);
 
@@ -1935,22 +1991,11 @@ int hlsl_emit_bytecode(struct hlsl_ctx *ctx, struct hlsl_ir_function_decl *entry
 
     transform_ir(ctx, lower_broadcasts, body, NULL);
     while (transform_ir(ctx, fold_redundant_casts, body, NULL));
-    do
-    {
-        progress = transform_ir(ctx, split_array_copies, body, NULL);
-        progress |= transform_ir(ctx, split_struct_copies, body, NULL);
-    }
-    while (progress);
+    run_passes(ctx, body, split_copy_passes, ARRAY_SIZE(split_copy_passes));
     transform_ir(ctx, split_matrix_copies, body, NULL);
     transform_ir(ctx, lower_narrowing_casts, body, NULL);
     transform_ir(ctx, lower_casts_to_bool, body, NULL);
-    do
-    {
-        progress = transform_ir(ctx, hlsl_fold_constants, body, NULL);
-        progress |= copy_propagation_execute(ctx, body);
-        progress |= transform_ir(ctx, remove_trivial_swizzles, body, NULL);
-    }
-    while (progress);
+    run_passes(ctx, body, simplify_passes, ARRAY_SIZE(simplify_passes));
 
     if (ctx->profile->major_version < 4)
         transform_ir(ctx, lower_division, body, NULL);
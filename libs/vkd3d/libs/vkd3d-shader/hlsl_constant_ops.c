@@ -371,7 +371,7 @@ static bool fold_mod(struct hlsl_ctx *ctx, struct hlsl_ir_constant *dst,
 
 bool hlsl_fold_constants(struct hlsl_ctx *ctx, struct hlsl_ir_node *instr, void *context)
 {
-    struct hlsl_ir_constant *arg1, *arg2 = NULL, *res;
+    struct hlsl_ir_constant *arg1, *arg2 = NULL, *res, folded;
     struct hlsl_ir_expr *expr;
     unsigned int i;
     bool success;
@@ -396,38 +396,38 @@ bool hlsl_fold_constants(struct hlsl_ctx *ctx, struct hlsl_ir_node *instr, void
     if (expr->operands[1].node)
         arg2 = hlsl_ir_constant(expr->operands[1].node);
 
-    if (!(res = hlsl_alloc(ctx, sizeof(*res))))
-        return false;
-    init_node(&res->node, HLSL_IR_CONSTANT, instr->data_type, instr->loc);
+    /* Fold into a temporary first, since IR nodes can't be freed. */
+    memset(&folded, 0, sizeof(folded));
+    init_node(&folded.node, HLSL_IR_CONSTANT, instr->data_type, instr->loc);
 
     switch (expr->op)
     {
         case HLSL_OP1_CAST:
-            success = fold_cast(ctx, res, arg1);
+            success = fold_cast(ctx, &folded, arg1);
             break;
 
         case HLSL_OP1_NEG:
-            success = fold_neg(ctx, res, arg1);
+            success = fold_neg(ctx, &folded, arg1);
             break;
 
         case HLSL_OP2_ADD:
-            success = fold_add(ctx, res, arg1, arg2);
+            success = fold_add(ctx, &folded, arg1, arg2);
             break;
 
         case HLSL_OP2_MUL:
-            success = fold_mul(ctx, res, arg1, arg2);
+            success = fold_mul(ctx, &folded, arg1, arg2);
             break;
 
         case HLSL_OP2_NEQUAL:
-            success = fold_nequal(ctx, res, arg1, arg2);
+            success = fold_nequal(ctx, &folded, arg1, arg2);
             break;
 
         case HLSL_OP2_DIV:
-            success = fold_div(ctx, res, arg1, arg2);
+            success = fold_div(ctx, &folded, arg1, arg2);
             break;
 
         case HLSL_OP2_MOD:
-            success = fold_mod(ctx, res, arg1, arg2);
+            success = fold_mod(ctx, &folded, arg1, arg2);
             break;
 
         default:
@@ -436,14 +436,14 @@ bool hlsl_fold_constants(struct hlsl_ctx *ctx, struct hlsl_ir_node *instr, void
             break;
     }
 
-    if (success)
-    {
-        list_add_before(&expr->node.entry, &res->node.entry);
-        hlsl_replace_node(&expr->node, &res->node);
-    }
-    else
-    {
-        vkd3d_free(res);
-    }
-    return success;
+    if (!success)
+        return false;
+
+    if (!(res = hlsl_new_constant(ctx, instr->data_type, &instr->loc)))
+        return false;
+    memcpy(res->value, folded.value, sizeof(res->value));
+
+    list_add_before(&expr->node.entry, &res->node.entry);
+    hlsl_replace_node(&expr->node, &res->node);
+    return true;
 }
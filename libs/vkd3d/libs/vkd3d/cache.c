@@ -0,0 +1,681 @@
+/*
+ * Persistent cache for DXBC to SPIR-V translation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "vkd3d_private.h"
+
+#include <stdio.h>
+#ifndef _WIN32
+# include <dirent.h>
+# include <errno.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# include <utime.h>
+#endif
+
+/* The cache is a directory with one file per entry, named after the full key.
+ * Entries are written to a temporary file and renamed into place, so
+ * concurrent readers in other processes either see a complete entry or none
+ * at all. Hits update the modification time of the entry, and once the total
+ * size exceeds the limit the least recently used entries are removed. */
+
+#define VKD3D_SHADER_CACHE_MAGIC       VKD3D_MAKE_TAG('V', 'K', 'S', 'C')
+#define VKD3D_SHADER_CACHE_DEFAULT_SIZE_MB 256u
+#define VKD3D_SHADER_CACHE_SUFFIX      ".spv"
+
+struct vkd3d_shader_cache_header
+{
+    uint32_t magic;
+    uint32_t size;
+    uint32_t checksum[4];
+    uint64_t hash;
+    uint64_t data_hash;
+};
+
+static uint64_t vkd3d_hash_data(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    size_t i;
+
+    /* FNV-1a */
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static uint64_t vkd3d_hash_uint(uint64_t hash, unsigned int value)
+{
+    return vkd3d_hash_data(hash, &value, sizeof(value));
+}
+
+static uint64_t vkd3d_hash_string(uint64_t hash, const char *str)
+{
+    if (!str)
+        return vkd3d_hash_uint(hash, ~0u);
+    return vkd3d_hash_data(hash, str, strlen(str) + 1);
+}
+
+static uint64_t vkd3d_hash_descriptor_binding(uint64_t hash, const struct vkd3d_shader_descriptor_binding *binding)
+{
+    hash = vkd3d_hash_uint(hash, binding->set);
+    hash = vkd3d_hash_uint(hash, binding->binding);
+    return vkd3d_hash_uint(hash, binding->count);
+}
+
+static uint64_t vkd3d_hash_interface_info(uint64_t hash, const struct vkd3d_shader_interface_info *info)
+{
+    unsigned int i;
+
+    hash = vkd3d_hash_uint(hash, info->binding_count);
+    for (i = 0; i < info->binding_count; ++i)
+    {
+        const struct vkd3d_shader_resource_binding *b = &info->bindings[i];
+
+        hash = vkd3d_hash_uint(hash, b->type);
+        hash = vkd3d_hash_uint(hash, b->register_space);
+        hash = vkd3d_hash_uint(hash, b->register_index);
+        hash = vkd3d_hash_uint(hash, b->shader_visibility);
+        hash = vkd3d_hash_uint(hash, b->flags);
+        hash = vkd3d_hash_descriptor_binding(hash, &b->binding);
+    }
+
+    hash = vkd3d_hash_uint(hash, info->push_constant_buffer_count);
+    for (i = 0; i < info->push_constant_buffer_count; ++i)
+    {
+        const struct vkd3d_shader_push_constant_buffer *b = &info->push_constant_buffers[i];
+
+        hash = vkd3d_hash_uint(hash, b->register_space);
+        hash = vkd3d_hash_uint(hash, b->register_index);
+        hash = vkd3d_hash_uint(hash, b->shader_visibility);
+        hash = vkd3d_hash_uint(hash, b->offset);
+        hash = vkd3d_hash_uint(hash, b->size);
+    }
+
+    hash = vkd3d_hash_uint(hash, info->combined_sampler_count);
+    for (i = 0; i < info->combined_sampler_count; ++i)
+    {
+        const struct vkd3d_shader_combined_resource_sampler *s = &info->combined_samplers[i];
+
+        hash = vkd3d_hash_uint(hash, s->resource_space);
+        hash = vkd3d_hash_uint(hash, s->resource_index);
+        hash = vkd3d_hash_uint(hash, s->sampler_space);
+        hash = vkd3d_hash_uint(hash, s->sampler_index);
+        hash = vkd3d_hash_uint(hash, s->shader_visibility);
+        hash = vkd3d_hash_uint(hash, s->flags);
+        hash = vkd3d_hash_descriptor_binding(hash, &s->binding);
+    }
+
+    hash = vkd3d_hash_uint(hash, info->uav_counter_count);
+    for (i = 0; i < info->uav_counter_count; ++i)
+    {
+        const struct vkd3d_shader_uav_counter_binding *c = &info->uav_counters[i];
+
+        hash = vkd3d_hash_uint(hash, c->register_space);
+        hash = vkd3d_hash_uint(hash, c->register_index);
+        hash = vkd3d_hash_uint(hash, c->shader_visibility);
+        hash = vkd3d_hash_descriptor_binding(hash, &c->binding);
+        hash = vkd3d_hash_uint(hash, c->offset);
+    }
+
+    return hash;
+}
+
+static uint64_t vkd3d_hash_spirv_target_info(uint64_t hash, const struct vkd3d_shader_spirv_target_info *info)
+{
+    unsigned int i;
+
+    hash = vkd3d_hash_string(hash, info->entry_point ? info->entry_point : "main");
+    hash = vkd3d_hash_uint(hash, info->environment);
+    hash = vkd3d_hash_uint(hash, info->extension_count);
+    for (i = 0; i < info->extension_count; ++i)
+        hash = vkd3d_hash_uint(hash, info->extensions[i]);
+    hash = vkd3d_hash_uint(hash, info->parameter_count);
+    for (i = 0; i < info->parameter_count; ++i)
+    {
+        const struct vkd3d_shader_parameter *p = &info->parameters[i];
+
+        hash = vkd3d_hash_uint(hash, p->name);
+        hash = vkd3d_hash_uint(hash, p->type);
+        hash = vkd3d_hash_uint(hash, p->data_type);
+        if (p->type == VKD3D_SHADER_PARAMETER_TYPE_SPECIALIZATION_CONSTANT)
+            hash = vkd3d_hash_uint(hash, p->u.specialization_constant.id);
+        else
+            hash = vkd3d_hash_uint(hash, p->u.immediate_constant.u.u32);
+    }
+    hash = vkd3d_hash_uint(hash, info->dual_source_blending);
+    hash = vkd3d_hash_uint(hash, info->output_swizzle_count);
+    for (i = 0; i < info->output_swizzle_count; ++i)
+        hash = vkd3d_hash_uint(hash, info->output_swizzles[i]);
+
+    return hash;
+}
+
+static uint64_t vkd3d_hash_transform_feedback_info(uint64_t hash,
+        const struct vkd3d_shader_transform_feedback_info *info)
+{
+    unsigned int i;
+
+    hash = vkd3d_hash_uint(hash, info->element_count);
+    for (i = 0; i < info->element_count; ++i)
+    {
+        const struct vkd3d_shader_transform_feedback_element *e = &info->elements[i];
+
+        hash = vkd3d_hash_uint(hash, e->stream_index);
+        hash = vkd3d_hash_string(hash, e->semantic_name);
+        hash = vkd3d_hash_uint(hash, e->semantic_index);
+        hash = vkd3d_hash_uint(hash, e->component_index);
+        hash = vkd3d_hash_uint(hash, e->component_count);
+        hash = vkd3d_hash_uint(hash, e->output_slot);
+    }
+    hash = vkd3d_hash_uint(hash, info->buffer_stride_count);
+    for (i = 0; i < info->buffer_stride_count; ++i)
+        hash = vkd3d_hash_uint(hash, info->buffer_strides[i]);
+
+    return hash;
+}
+
+static uint64_t vkd3d_hash_descriptor_offset_info(uint64_t hash,
+        const struct vkd3d_shader_descriptor_offset_info *info, const struct vkd3d_shader_interface_info *interface)
+{
+    unsigned int i;
+
+    hash = vkd3d_hash_uint(hash, info->descriptor_table_offset);
+    hash = vkd3d_hash_uint(hash, info->descriptor_table_count);
+    for (i = 0; info->binding_offsets && i < interface->binding_count; ++i)
+    {
+        hash = vkd3d_hash_uint(hash, info->binding_offsets[i].static_offset);
+        hash = vkd3d_hash_uint(hash, info->binding_offsets[i].dynamic_offset_index);
+    }
+    for (i = 0; info->uav_counter_offsets && i < interface->uav_counter_count; ++i)
+    {
+        hash = vkd3d_hash_uint(hash, info->uav_counter_offsets[i].static_offset);
+        hash = vkd3d_hash_uint(hash, info->uav_counter_offsets[i].dynamic_offset_index);
+    }
+
+    return hash;
+}
+
+/* Compute the key identifying the result of a compilation. This fails for
+ * inputs that can't be safely cached, e.g. unknown chained structures. */
+bool vkd3d_shader_cache_get_key(const struct vkd3d_shader_compile_info *compile_info,
+        struct vkd3d_shader_cache_key *key)
+{
+    const struct vkd3d_shader_interface_info *interface = NULL;
+    const struct
+    {
+        enum vkd3d_shader_structure_type type;
+        const void *next;
+    } *s;
+    const uint32_t *dxbc = compile_info->source.code;
+    struct vkd3d_shader_signature signature;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    unsigned int i;
+
+    if (compile_info->source_type != VKD3D_SHADER_SOURCE_DXBC_TPF
+            || compile_info->source.size < 5 * sizeof(uint32_t)
+            || dxbc[0] != VKD3D_MAKE_TAG('D', 'X', 'B', 'C'))
+        return false;
+
+    /* A cache hit skips the compiler, so the container and its checksum have
+     * to be validated here. Invalid shaders go through the compiler, which
+     * reports the error. */
+    if (vkd3d_shader_parse_input_signature(&compile_info->source, &signature, NULL) < 0)
+        return false;
+    vkd3d_shader_free_shader_signature(&signature);
+    memcpy(key->checksum, &dxbc[1], sizeof(key->checksum));
+
+    hash = vkd3d_hash_string(hash, vkd3d_shader_get_version(NULL, NULL));
+    hash = vkd3d_hash_data(hash, &compile_info->source.size, sizeof(compile_info->source.size));
+    hash = vkd3d_hash_uint(hash, compile_info->target_type);
+    hash = vkd3d_hash_uint(hash, compile_info->option_count);
+    for (i = 0; i < compile_info->option_count; ++i)
+    {
+        hash = vkd3d_hash_uint(hash, compile_info->options[i].name);
+        hash = vkd3d_hash_uint(hash, compile_info->options[i].value);
+    }
+
+    for (s = compile_info->next; s; s = s->next)
+    {
+        hash = vkd3d_hash_uint(hash, s->type);
+        switch (s->type)
+        {
+            case VKD3D_SHADER_STRUCTURE_TYPE_INTERFACE_INFO:
+                interface = (const struct vkd3d_shader_interface_info *)s;
+                hash = vkd3d_hash_interface_info(hash, interface);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_SPIRV_TARGET_INFO:
+                hash = vkd3d_hash_spirv_target_info(hash, (const struct vkd3d_shader_spirv_target_info *)s);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_TRANSFORM_FEEDBACK_INFO:
+                hash = vkd3d_hash_transform_feedback_info(hash,
+                        (const struct vkd3d_shader_transform_feedback_info *)s);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_DESCRIPTOR_OFFSET_INFO:
+                if (!interface)
+                    return false;
+                hash = vkd3d_hash_descriptor_offset_info(hash,
+                        (const struct vkd3d_shader_descriptor_offset_info *)s, interface);
+                break;
+
+            default:
+                TRACE("Not caching shader with structure type %#x.\n", s->type);
+                return false;
+        }
+    }
+
+    key->hash = hash;
+    return true;
+}
+
+struct vkd3d_shader_cache_file
+{
+    char *name;
+    uint64_t size;
+    uint64_t time;
+};
+
+static bool vkd3d_shader_cache_is_entry_name(const char *name)
+{
+    size_t len = strlen(name), suffix_len = strlen(VKD3D_SHADER_CACHE_SUFFIX);
+
+    return len > suffix_len && !strcmp(name + len - suffix_len, VKD3D_SHADER_CACHE_SUFFIX);
+}
+
+static bool vkd3d_shader_cache_add_file(struct vkd3d_shader_cache_file **files, size_t *capacity,
+        size_t *count, const char *name, uint64_t size, uint64_t time)
+{
+    struct vkd3d_shader_cache_file *file;
+
+    if (!vkd3d_array_reserve((void **)files, capacity, *count + 1, sizeof(**files)))
+        return false;
+    file = &(*files)[*count];
+    if (!(file->name = vkd3d_strdup(name)))
+        return false;
+    file->size = size;
+    file->time = time;
+    ++*count;
+    return true;
+}
+
+/* List the cache entries with their size and last use time. */
+static bool vkd3d_shader_cache_list_files(const struct vkd3d_shader_cache *cache,
+        struct vkd3d_shader_cache_file **files, size_t *count)
+{
+    size_t capacity = 0;
+    bool ret = true;
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    char *pattern;
+    size_t size;
+    HANDLE find;
+#else
+    struct dirent *entry;
+    char *filename;
+    struct stat st;
+    size_t size;
+    DIR *dir;
+#endif
+
+    *files = NULL;
+    *count = 0;
+
+#ifdef _WIN32
+    size = strlen(cache->path) + 8;
+    if (!(pattern = vkd3d_malloc(size)))
+        return false;
+    snprintf(pattern, size, "%s/*%s", cache->path, VKD3D_SHADER_CACHE_SUFFIX);
+    find = FindFirstFileA(pattern, &data);
+    vkd3d_free(pattern);
+    if (find == INVALID_HANDLE_VALUE)
+        return true;
+    do
+    {
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || !vkd3d_shader_cache_is_entry_name(data.cFileName))
+            continue;
+        if (!(ret = vkd3d_shader_cache_add_file(files, &capacity, count, data.cFileName,
+                ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow,
+                ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime)))
+            break;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    if (!(dir = opendir(cache->path)))
+        return true;
+    size = strlen(cache->path) + 256;
+    if (!(filename = vkd3d_malloc(size)))
+    {
+        closedir(dir);
+        return false;
+    }
+    while ((entry = readdir(dir)))
+    {
+        if (!vkd3d_shader_cache_is_entry_name(entry->d_name))
+            continue;
+        snprintf(filename, size, "%s/%s", cache->path, entry->d_name);
+        if (stat(filename, &st) || !S_ISREG(st.st_mode))
+            continue;
+        if (!(ret = vkd3d_shader_cache_add_file(files, &capacity, count, entry->d_name, st.st_size, st.st_mtime)))
+            break;
+    }
+    vkd3d_free(filename);
+    closedir(dir);
+#endif
+
+    return ret;
+}
+
+static void vkd3d_shader_cache_free_files(struct vkd3d_shader_cache_file *files, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; ++i)
+        vkd3d_free(files[i].name);
+    vkd3d_free(files);
+}
+
+static int vkd3d_shader_cache_file_compare(const void *a, const void *b)
+{
+    const struct vkd3d_shader_cache_file *file_a = a, *file_b = b;
+
+    if (file_a->time != file_b->time)
+        return file_a->time < file_b->time ? -1 : 1;
+    return 0;
+}
+
+/* Remove the least recently used entries until the cache is below three
+ * quarters of its size limit. The directory is shared with other processes,
+ * so the total size is recomputed from the files that are actually there. */
+static void vkd3d_shader_cache_evict(struct vkd3d_shader_cache *cache)
+{
+    struct vkd3d_shader_cache_file *files;
+    uint64_t total = 0, target;
+    size_t count, i, size;
+    char *filename;
+
+    if (!vkd3d_shader_cache_list_files(cache, &files, &count))
+        return;
+
+    for (i = 0; i < count; ++i)
+        total += files[i].size;
+
+    target = cache->max_size / 4 * 3;
+    size = strlen(cache->path) + 256;
+    if (total > target && (filename = vkd3d_malloc(size)))
+    {
+        qsort(files, count, sizeof(*files), vkd3d_shader_cache_file_compare);
+        for (i = 0; i < count && total > target; ++i)
+        {
+            snprintf(filename, size, "%s/%s", cache->path, files[i].name);
+            if (!remove(filename))
+            {
+                total -= files[i].size;
+                ++cache->evictions;
+            }
+        }
+        vkd3d_free(filename);
+    }
+
+    TRACE("Shader cache %s: %"PRIu64" bytes in %zu entries.\n", debugstr_a(cache->path), total, count);
+    cache->total_size = total;
+    vkd3d_shader_cache_free_files(files, count);
+}
+
+/* Create the cache directory, along with any missing parents. */
+static bool vkd3d_shader_cache_create_directory(const char *path)
+{
+    bool ret = true;
+    char *dir, *p;
+
+    if (!(dir = vkd3d_strdup(path)))
+        return false;
+
+    for (p = dir + 1; ; ++p)
+    {
+        if (*p && *p != '/' && *p != '\\')
+            continue;
+        if (p[-1] != '/' && p[-1] != '\\' && p[-1] != ':')
+        {
+            char c = *p;
+
+            *p = 0;
+#ifdef _WIN32
+            ret = CreateDirectoryA(dir, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+            ret = !mkdir(dir, 0777) || errno == EEXIST;
+#endif
+            *p = c;
+        }
+        if (!*p)
+            break;
+    }
+
+    vkd3d_free(dir);
+    return ret;
+}
+
+void vkd3d_shader_cache_init(struct vkd3d_shader_cache *cache)
+{
+    const char *path = getenv("VKD3D_SHADER_CACHE_PATH");
+    struct vkd3d_shader_cache_file *files;
+    unsigned int size_mb;
+    size_t count, i;
+
+    memset(cache, 0, sizeof(*cache));
+
+    if (!path || !*path)
+        return;
+
+    size_mb = vkd3d_env_var_as_uint("VKD3D_SHADER_CACHE_SIZE", VKD3D_SHADER_CACHE_DEFAULT_SIZE_MB);
+    if (!size_mb)
+        return;
+
+    if (!vkd3d_shader_cache_create_directory(path))
+    {
+        WARN("Failed to create shader cache directory %s.\n", debugstr_a(path));
+        return;
+    }
+
+    if (vkd3d_mutex_init(&cache->mutex))
+        return;
+    if (!(cache->path = vkd3d_strdup(path)))
+    {
+        vkd3d_mutex_destroy(&cache->mutex);
+        return;
+    }
+    cache->max_size = (uint64_t)size_mb << 20;
+
+    if (vkd3d_shader_cache_list_files(cache, &files, &count))
+    {
+        for (i = 0; i < count; ++i)
+            cache->total_size += files[i].size;
+        vkd3d_shader_cache_free_files(files, count);
+    }
+    if (cache->total_size > cache->max_size)
+        vkd3d_shader_cache_evict(cache);
+
+    TRACE("Using shader cache %s, %u MiB.\n", debugstr_a(cache->path), size_mb);
+}
+
+void vkd3d_shader_cache_cleanup(struct vkd3d_shader_cache *cache)
+{
+    if (!cache->path)
+        return;
+
+    TRACE("Shader cache %s: %d hits, %d misses, %d stores, %d failed stores, %u evictions.\n",
+            debugstr_a(cache->path), (int)cache->hits, (int)cache->misses, (int)cache->stores,
+            (int)cache->store_failures, cache->evictions);
+
+    vkd3d_free(cache->path);
+    cache->path = NULL;
+    vkd3d_mutex_destroy(&cache->mutex);
+}
+
+static char *vkd3d_shader_cache_get_filename(const struct vkd3d_shader_cache *cache,
+        const struct vkd3d_shader_cache_key *key, const char *suffix)
+{
+    size_t size = strlen(cache->path) + strlen(suffix) + 64;
+    char *filename;
+
+    if (!(filename = vkd3d_malloc(size)))
+        return NULL;
+    snprintf(filename, size, "%s/%08x%08x%08x%08x%08x%08x%s%s", cache->path,
+            key->checksum[0], key->checksum[1], key->checksum[2], key->checksum[3],
+            (uint32_t)(key->hash >> 32), (uint32_t)key->hash, VKD3D_SHADER_CACHE_SUFFIX, suffix);
+    return filename;
+}
+
+/* Mark an entry as recently used, so that eviction keeps it. */
+static void vkd3d_shader_cache_touch(const char *filename)
+{
+#ifdef _WIN32
+    FILETIME now;
+    HANDLE file;
+
+    if ((file = CreateFileA(filename, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+        return;
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, NULL, &now);
+    CloseHandle(file);
+#else
+    utime(filename, NULL);
+#endif
+}
+
+bool vkd3d_shader_cache_get(struct vkd3d_shader_cache *cache,
+        const struct vkd3d_shader_cache_key *key, struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_cache_header header;
+    char *filename;
+    void *code;
+    FILE *f;
+
+    if (!cache->path)
+        return false;
+
+    if (!(filename = vkd3d_shader_cache_get_filename(cache, key, "")))
+        return false;
+
+    if (!(f = fopen(filename, "rb")))
+        goto miss;
+
+    if (fread(&header, sizeof(header), 1, f) != 1
+            || header.magic != VKD3D_SHADER_CACHE_MAGIC
+            || memcmp(header.checksum, key->checksum, sizeof(header.checksum))
+            || header.hash != key->hash
+            || !header.size || header.size > cache->max_size)
+    {
+        fclose(f);
+        goto miss;
+    }
+
+    if (!(code = vkd3d_malloc(header.size)))
+    {
+        fclose(f);
+        goto miss;
+    }
+    if (fread(code, 1, header.size, f) != header.size
+            || vkd3d_hash_data(0xcbf29ce484222325ull, code, header.size) != header.data_hash)
+    {
+        WARN("Ignoring corrupted shader cache entry.\n");
+        vkd3d_free(code);
+        fclose(f);
+        goto miss;
+    }
+    fclose(f);
+
+    vkd3d_shader_cache_touch(filename);
+    vkd3d_free(filename);
+
+    spirv->code = code;
+    spirv->size = header.size;
+    InterlockedIncrement(&cache->hits);
+    return true;
+
+miss:
+    vkd3d_free(filename);
+    InterlockedIncrement(&cache->misses);
+    return false;
+}
+
+void vkd3d_shader_cache_put(struct vkd3d_shader_cache *cache,
+        const struct vkd3d_shader_cache_key *key, const struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_cache_header header;
+    char suffix[32], *filename, *tmp_filename;
+    static LONG tmp_counter;
+    bool ret = false;
+    FILE *f;
+
+    if (!cache->path || !spirv->size || spirv->size + sizeof(header) > cache->max_size / 4)
+        return;
+
+    header.magic = VKD3D_SHADER_CACHE_MAGIC;
+    header.size = spirv->size;
+    memcpy(header.checksum, key->checksum, sizeof(header.checksum));
+    header.hash = key->hash;
+    header.data_hash = vkd3d_hash_data(0xcbf29ce484222325ull, spirv->code, spirv->size);
+
+#ifdef _WIN32
+    snprintf(suffix, sizeof(suffix), ".%lx.%x", GetCurrentProcessId(), InterlockedIncrement(&tmp_counter));
+#else
+    snprintf(suffix, sizeof(suffix), ".%lx.%x", (unsigned long)getpid(), InterlockedIncrement(&tmp_counter));
+#endif
+
+    filename = vkd3d_shader_cache_get_filename(cache, key, "");
+    tmp_filename = vkd3d_shader_cache_get_filename(cache, key, suffix);
+    if (!filename || !tmp_filename)
+        goto done;
+
+    if (!(f = fopen(tmp_filename, "wb")))
+        goto done;
+    ret = fwrite(&header, sizeof(header), 1, f) == 1
+            && fwrite(spirv->code, 1, spirv->size, f) == spirv->size;
+    ret = !fclose(f) && ret;
+
+#ifdef _WIN32
+    ret = ret && MoveFileExA(tmp_filename, filename, MOVEFILE_REPLACE_EXISTING);
+#else
+    ret = ret && !rename(tmp_filename, filename);
+#endif
+    if (!ret)
+        remove(tmp_filename);
+
+done:
+    vkd3d_free(tmp_filename);
+    vkd3d_free(filename);
+
+    if (!ret)
+    {
+        InterlockedIncrement(&cache->store_failures);
+        return;
+    }
+    InterlockedIncrement(&cache->stores);
+
+    vkd3d_mutex_lock(&cache->mutex);
+    cache->total_size += sizeof(header) + spirv->size;
+    if (cache->total_size > cache->max_size)
+        vkd3d_shader_cache_evict(cache);
+    vkd3d_mutex_unlock(&cache->mutex);
+}
@@ -21,6 +21,10 @@
 #include "vkd3d_private.h"
 #include "vkd3d_shaders.h"
 
+#ifndef _WIN32
+# include <unistd.h>
+#endif
+
 /* ID3D12RootSignature */
 static inline struct d3d12_root_signature *impl_from_ID3D12RootSignature(ID3D12RootSignature *iface)
 {
@@ -1944,22 +1948,57 @@ struct d3d12_pipeline_state *unsafe_impl_from_ID3D12PipelineState(ID3D12Pipeline
     return impl_from_ID3D12PipelineState(iface);
 }
 
-static HRESULT create_shader_stage(struct d3d12_device *device,
-        struct VkPipelineShaderStageCreateInfo *stage_desc, enum VkShaderStageFlagBits stage,
-        const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface)
+static void shader_compile_info_init(struct vkd3d_shader_compile_info *compile_info,
+        const D3D12_SHADER_BYTECODE *code, const void *next)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    struct vkd3d_shader_compile_info compile_info;
-    struct VkShaderModuleCreateInfo shader_desc;
-    struct vkd3d_shader_code spirv = {0};
-    VkResult vr;
-    int ret;
-
     static const struct vkd3d_shader_compile_option options[] =
     {
         {VKD3D_SHADER_COMPILE_OPTION_API_VERSION, VKD3D_SHADER_API_VERSION_1_4},
     };
 
+    compile_info->type = VKD3D_SHADER_STRUCTURE_TYPE_COMPILE_INFO;
+    compile_info->next = next;
+    compile_info->source.code = code->pShaderBytecode;
+    compile_info->source.size = code->BytecodeLength;
+    compile_info->source_type = VKD3D_SHADER_SOURCE_DXBC_TPF;
+    compile_info->target_type = VKD3D_SHADER_TARGET_SPIRV_BINARY;
+    compile_info->options = options;
+    compile_info->option_count = ARRAY_SIZE(options);
+    compile_info->log_level = VKD3D_SHADER_LOG_NONE;
+    compile_info->source_name = NULL;
+}
+
+static int compile_shader(struct d3d12_device *device,
+        const struct vkd3d_shader_compile_info *compile_info, struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_cache_key key;
+    bool cacheable;
+    int ret;
+
+    cacheable = device->shader_cache.path && vkd3d_shader_cache_get_key(compile_info, &key);
+    if (cacheable && vkd3d_shader_cache_get(&device->shader_cache, &key, spirv))
+        return VKD3D_OK;
+
+    if ((ret = vkd3d_shader_compile(compile_info, spirv, NULL)) < 0)
+    {
+        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
+        return ret;
+    }
+    if (cacheable)
+        vkd3d_shader_cache_put(&device->shader_cache, &key, spirv);
+
+    return VKD3D_OK;
+}
+
+/* Takes ownership of "spirv". */
+static HRESULT create_shader_module(struct d3d12_device *device,
+        struct VkPipelineShaderStageCreateInfo *stage_desc, enum VkShaderStageFlagBits stage,
+        struct vkd3d_shader_code *spirv)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct VkShaderModuleCreateInfo shader_desc;
+    VkResult vr;
+
     stage_desc->sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     stage_desc->pNext = NULL;
     stage_desc->flags = 0;
@@ -1970,28 +2009,11 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     shader_desc.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     shader_desc.pNext = NULL;
     shader_desc.flags = 0;
-
-    compile_info.type = VKD3D_SHADER_STRUCTURE_TYPE_COMPILE_INFO;
-    compile_info.next = shader_interface;
-    compile_info.source.code = code->pShaderBytecode;
-    compile_info.source.size = code->BytecodeLength;
-    compile_info.source_type = VKD3D_SHADER_SOURCE_DXBC_TPF;
-    compile_info.target_type = VKD3D_SHADER_TARGET_SPIRV_BINARY;
-    compile_info.options = options;
-    compile_info.option_count = ARRAY_SIZE(options);
-    compile_info.log_level = VKD3D_SHADER_LOG_NONE;
-    compile_info.source_name = NULL;
-
-    if ((ret = vkd3d_shader_compile(&compile_info, &spirv, NULL)) < 0)
-    {
-        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
-        return hresult_from_vkd3d_result(ret);
-    }
-    shader_desc.codeSize = spirv.size;
-    shader_desc.pCode = spirv.code;
+    shader_desc.codeSize = spirv->size;
+    shader_desc.pCode = spirv->code;
 
     vr = VK_CALL(vkCreateShaderModule(device->vk_device, &shader_desc, NULL, &stage_desc->module));
-    vkd3d_shader_free_shader_code(&spirv);
+    vkd3d_shader_free_shader_code(spirv);
     if (vr < 0)
     {
         WARN("Failed to create Vulkan shader module, vr %d.\n", vr);
@@ -2001,6 +2023,225 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     return S_OK;
 }
 
+static HRESULT create_shader_stage(struct d3d12_device *device,
+        struct VkPipelineShaderStageCreateInfo *stage_desc, enum VkShaderStageFlagBits stage,
+        const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface)
+{
+    struct vkd3d_shader_compile_info compile_info;
+    struct vkd3d_shader_code spirv = {0};
+    int ret;
+
+    shader_compile_info_init(&compile_info, code, shader_interface);
+    if ((ret = compile_shader(device, &compile_info, &spirv)) < 0)
+        return hresult_from_vkd3d_result(ret);
+
+    return create_shader_module(device, stage_desc, stage, &spirv);
+}
+
+/* A set of compile tasks submitted by a single caller. Idle workers take
+ * tasks from the first queued batch; the submitting thread takes part in the
+ * work and returns once all tasks of its batch are done, so pipeline creation
+ * stays synchronous. */
+struct vkd3d_shader_compile_batch
+{
+    struct list entry;
+    struct vkd3d_shader_compile_task *tasks;
+    unsigned int count;
+    unsigned int next;
+    unsigned int remaining;
+};
+
+static void vkd3d_shader_compile_task_execute(struct vkd3d_shader_compile_task *task,
+        struct d3d12_device *device)
+{
+    task->ret = compile_shader(device, &task->compile_info, &task->spirv);
+}
+
+/* The compiler mutex must be held. */
+static struct vkd3d_shader_compile_task *vkd3d_shader_compile_batch_get_task(
+        struct vkd3d_shader_compile_batch *batch)
+{
+    struct vkd3d_shader_compile_task *task = &batch->tasks[batch->next];
+
+    if (++batch->next == batch->count)
+        list_remove(&batch->entry);
+
+    return task;
+}
+
+static void *vkd3d_shader_compiler_main(void *arg)
+{
+    struct vkd3d_shader_compiler *compiler = arg;
+    struct vkd3d_shader_compile_batch *batch;
+    struct vkd3d_shader_compile_task *task;
+    int rc;
+
+    vkd3d_set_thread_name("vkd3d_compile");
+
+    vkd3d_mutex_lock(&compiler->mutex);
+
+    for (;;)
+    {
+        if (list_empty(&compiler->batches) && !compiler->should_exit
+                && (rc = vkd3d_cond_wait(&compiler->cond, &compiler->mutex)))
+        {
+            ERR("Failed to wait on condition variable, error %d.\n", rc);
+            break;
+        }
+
+        if (compiler->should_exit)
+            break;
+
+        if (list_empty(&compiler->batches))
+            continue;
+
+        batch = LIST_ENTRY(list_head(&compiler->batches), struct vkd3d_shader_compile_batch, entry);
+        task = vkd3d_shader_compile_batch_get_task(batch);
+
+        vkd3d_mutex_unlock(&compiler->mutex);
+        vkd3d_shader_compile_task_execute(task, compiler->device);
+        vkd3d_mutex_lock(&compiler->mutex);
+
+        if (!--batch->remaining)
+            vkd3d_cond_broadcast(&compiler->done_cond);
+    }
+
+    vkd3d_mutex_unlock(&compiler->mutex);
+
+    return NULL;
+}
+
+static unsigned int vkd3d_get_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? count : 1;
+#endif
+}
+
+HRESULT vkd3d_shader_compiler_init(struct vkd3d_shader_compiler *compiler, struct d3d12_device *device)
+{
+    unsigned int thread_count;
+    int rc;
+
+    memset(compiler, 0, sizeof(*compiler));
+    compiler->device = device;
+    list_init(&compiler->batches);
+
+    thread_count = vkd3d_get_cpu_count() - 1;
+    thread_count = min(thread_count, VKD3D_MAX_SHADER_COMPILE_THREADS);
+    thread_count = vkd3d_env_var_as_uint("VKD3D_SHADER_COMPILE_THREADS", thread_count);
+    compiler->max_thread_count = min(thread_count, VKD3D_MAX_SHADER_COMPILE_THREADS);
+
+    TRACE("Using up to %u shader compile threads.\n", compiler->max_thread_count);
+
+    if ((rc = vkd3d_mutex_init(&compiler->mutex)))
+    {
+        ERR("Failed to initialize mutex, error %d.\n", rc);
+        return hresult_from_errno(rc);
+    }
+
+    if ((rc = vkd3d_cond_init(&compiler->cond)))
+    {
+        ERR("Failed to initialize condition variable, error %d.\n", rc);
+        vkd3d_mutex_destroy(&compiler->mutex);
+        return hresult_from_errno(rc);
+    }
+
+    if ((rc = vkd3d_cond_init(&compiler->done_cond)))
+    {
+        ERR("Failed to initialize condition variable, error %d.\n", rc);
+        vkd3d_cond_destroy(&compiler->cond);
+        vkd3d_mutex_destroy(&compiler->mutex);
+        return hresult_from_errno(rc);
+    }
+
+    return S_OK;
+}
+
+void vkd3d_shader_compiler_cleanup(struct vkd3d_shader_compiler *compiler)
+{
+    unsigned int i;
+
+    vkd3d_mutex_lock(&compiler->mutex);
+    compiler->should_exit = true;
+    vkd3d_cond_broadcast(&compiler->cond);
+    vkd3d_mutex_unlock(&compiler->mutex);
+
+    for (i = 0; i < compiler->thread_count; ++i)
+        vkd3d_join_thread(compiler->device->vkd3d_instance, &compiler->threads[i]);
+
+    vkd3d_cond_destroy(&compiler->done_cond);
+    vkd3d_cond_destroy(&compiler->cond);
+    vkd3d_mutex_destroy(&compiler->mutex);
+}
+
+/* Threads are started on first use, since many devices never create a
+ * pipeline with more than one stage. The compiler mutex must be held. */
+static void vkd3d_shader_compiler_start_threads(struct vkd3d_shader_compiler *compiler, unsigned int count)
+{
+    count = min(count, compiler->max_thread_count);
+
+    while (compiler->thread_count < count)
+    {
+        if (FAILED(vkd3d_create_thread(compiler->device->vkd3d_instance, vkd3d_shader_compiler_main,
+                compiler, &compiler->threads[compiler->thread_count])))
+        {
+            compiler->max_thread_count = compiler->thread_count;
+            break;
+        }
+        ++compiler->thread_count;
+    }
+}
+
+void vkd3d_shader_compiler_run(struct vkd3d_shader_compiler *compiler,
+        struct vkd3d_shader_compile_task *tasks, unsigned int count)
+{
+    struct vkd3d_shader_compile_batch batch;
+    struct vkd3d_shader_compile_task *task;
+    unsigned int i;
+
+    if (count < 2 || !compiler->max_thread_count)
+    {
+        for (i = 0; i < count; ++i)
+            vkd3d_shader_compile_task_execute(&tasks[i], compiler->device);
+        return;
+    }
+
+    batch.tasks = tasks;
+    batch.count = count;
+    batch.next = 0;
+    batch.remaining = count;
+
+    vkd3d_mutex_lock(&compiler->mutex);
+
+    vkd3d_shader_compiler_start_threads(compiler, count - 1);
+    list_add_tail(&compiler->batches, &batch.entry);
+    vkd3d_cond_broadcast(&compiler->cond);
+
+    while (batch.next < batch.count)
+    {
+        task = vkd3d_shader_compile_batch_get_task(&batch);
+
+        vkd3d_mutex_unlock(&compiler->mutex);
+        vkd3d_shader_compile_task_execute(task, compiler->device);
+        vkd3d_mutex_lock(&compiler->mutex);
+
+        --batch.remaining;
+    }
+
+    while (batch.remaining)
+        vkd3d_cond_wait(&compiler->done_cond, &compiler->mutex);
+
+    vkd3d_mutex_unlock(&compiler->mutex);
+}
+
 static int vkd3d_scan_dxbc(const D3D12_SHADER_BYTECODE *code,
         struct vkd3d_shader_scan_descriptor_info *descriptor_info)
 {
@@ -2729,6 +2970,15 @@ static VkLogicOp vk_logic_op_from_d3d12(D3D12_LOGIC_OP op)
     }
 }
 
+struct d3d12_graphics_shader_stage_info
+{
+    enum VkShaderStageFlagBits stage;
+    struct vkd3d_shader_interface_info shader_interface;
+    struct vkd3d_shader_spirv_target_info target_info;
+    struct vkd3d_shader_transform_feedback_info xfb_info;
+    struct vkd3d_shader_descriptor_offset_info offset_info;
+};
+
 static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *state,
         struct d3d12_device *device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC *desc)
 {
@@ -2741,6 +2991,8 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     uint32_t instance_divisors[D3D12_VS_INPUT_REGISTER_COUNT];
     struct vkd3d_shader_spirv_target_info *stage_target_info;
     uint32_t aligned_offsets[D3D12_VS_INPUT_REGISTER_COUNT];
+    struct d3d12_graphics_shader_stage_info stage_infos[VKD3D_MAX_SHADER_STAGES];
+    struct vkd3d_shader_compile_task tasks[VKD3D_MAX_SHADER_STAGES];
     struct vkd3d_shader_descriptor_offset_info offset_info;
     struct vkd3d_shader_parameter ps_shader_parameters[1];
     struct vkd3d_shader_transform_feedback_info xfb_info;
@@ -2753,7 +3005,7 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     VkShaderStageFlagBits xfb_stage = 0;
     VkSampleCountFlagBits sample_count;
     const struct vkd3d_format *format;
-    unsigned int instance_divisor;
+    unsigned int instance_divisor, task_count;
     VkVertexInputRate input_rate;
     unsigned int i, j;
     size_t rt_count;
@@ -2777,7 +3029,7 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         enum VkShaderStageFlagBits stage;
         ptrdiff_t offset;
     }
-    shader_stages[] =
+    shader_stages[VKD3D_MAX_SHADER_STAGES] =
     {
         {VK_SHADER_STAGE_VERTEX_BIT,                  offsetof(D3D12_GRAPHICS_PIPELINE_STATE_DESC, VS)},
         {VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,    offsetof(D3D12_GRAPHICS_PIPELINE_STATE_DESC, HS)},
@@ -3011,10 +3263,11 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         offset_info.uav_counter_offsets = root_signature->uav_counter_offsets;
     }
 
-    for (i = 0; i < ARRAY_SIZE(shader_stages); ++i)
+    for (i = 0, task_count = 0; i < ARRAY_SIZE(shader_stages); ++i)
     {
         const D3D12_SHADER_BYTECODE *b = (const void *)((uintptr_t)desc + shader_stages[i].offset);
         const struct vkd3d_shader_code dxbc = {b->pShaderBytecode, b->BytecodeLength};
+        struct d3d12_graphics_shader_stage_info *stage_info = &stage_infos[task_count];
 
         if (!b->pShaderBytecode)
             continue;
@@ -3062,23 +3315,52 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
                 goto fail;
         }
 
-        shader_interface.next = NULL;
-        xfb_info.next = NULL;
-        ps_target_info.next = NULL;
-        target_info.next = NULL;
-        offset_info.next = NULL;
+        /* The chained structures differ between stages, and all stages are
+         * compiled at once below, so each of them needs its own copy. */
+        stage_info->stage = shader_stages[i].stage;
+        stage_info->shader_interface = shader_interface;
+        stage_info->shader_interface.next = NULL;
+        stage_info->target_info = *stage_target_info;
+        stage_info->target_info.next = NULL;
         if (shader_stages[i].stage == xfb_stage)
-            vkd3d_prepend_struct(&shader_interface, &xfb_info);
-        vkd3d_prepend_struct(&shader_interface, stage_target_info);
+        {
+            stage_info->xfb_info = xfb_info;
+            vkd3d_prepend_struct(&stage_info->shader_interface, &stage_info->xfb_info);
+        }
+        vkd3d_prepend_struct(&stage_info->shader_interface, &stage_info->target_info);
         if (root_signature->descriptor_offsets)
-            vkd3d_prepend_struct(&shader_interface, &offset_info);
+        {
+            stage_info->offset_info = offset_info;
+            vkd3d_prepend_struct(&stage_info->shader_interface, &stage_info->offset_info);
+        }
 
-        if (FAILED(hr = create_shader_stage(device, &graphics->stages[graphics->stage_count],
-                shader_stages[i].stage, b, &shader_interface)))
-            goto fail;
+        shader_compile_info_init(&tasks[task_count].compile_info, b, &stage_info->shader_interface);
+        tasks[task_count].spirv.code = NULL;
+        tasks[task_count].spirv.size = 0;
+        ++task_count;
+    }
+
+    vkd3d_shader_compiler_run(&device->shader_compiler, tasks, task_count);
+
+    for (i = 0, hr = S_OK; i < task_count; ++i)
+    {
+        if (SUCCEEDED(hr) && tasks[i].ret < 0)
+            hr = hresult_from_vkd3d_result(tasks[i].ret);
+
+        if (FAILED(hr))
+        {
+            vkd3d_shader_free_shader_code(&tasks[i].spirv);
+            continue;
+        }
+
+        if (FAILED(hr = create_shader_module(device, &graphics->stages[graphics->stage_count],
+                stage_infos[i].stage, &tasks[i].spirv)))
+            continue;
 
         ++graphics->stage_count;
     }
+    if (FAILED(hr))
+        goto fail;
 
     graphics->attribute_count = desc->InputLayout.NumElements;
     if (graphics->attribute_count > ARRAY_SIZE(graphics->attributes))
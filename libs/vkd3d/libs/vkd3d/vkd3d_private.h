@@ -439,6 +439,66 @@ HRESULT vkd3d_render_pass_cache_find(struct vkd3d_render_pass_cache *cache, stru
         const struct vkd3d_render_pass_key *key, VkRenderPass *vk_render_pass);
 void vkd3d_render_pass_cache_init(struct vkd3d_render_pass_cache *cache);
 
+struct vkd3d_shader_cache_key
+{
+    uint32_t checksum[4];
+    uint64_t hash;
+};
+
+struct vkd3d_shader_cache
+{
+    char *path;
+    uint64_t max_size;
+
+    struct vkd3d_mutex mutex;
+    uint64_t total_size;
+
+    LONG hits;
+    LONG misses;
+    LONG stores;
+    LONG store_failures;
+    unsigned int evictions;
+};
+
+void vkd3d_shader_cache_cleanup(struct vkd3d_shader_cache *cache);
+bool vkd3d_shader_cache_get(struct vkd3d_shader_cache *cache,
+        const struct vkd3d_shader_cache_key *key, struct vkd3d_shader_code *spirv);
+bool vkd3d_shader_cache_get_key(const struct vkd3d_shader_compile_info *compile_info,
+        struct vkd3d_shader_cache_key *key);
+void vkd3d_shader_cache_init(struct vkd3d_shader_cache *cache);
+void vkd3d_shader_cache_put(struct vkd3d_shader_cache *cache,
+        const struct vkd3d_shader_cache_key *key, const struct vkd3d_shader_code *spirv);
+
+#define VKD3D_MAX_SHADER_COMPILE_THREADS 4u
+
+struct vkd3d_shader_compile_task
+{
+    struct vkd3d_shader_compile_info compile_info;
+    struct vkd3d_shader_code spirv;
+    int ret;
+};
+
+/* Worker threads translating the shader stages of a pipeline in parallel. */
+struct vkd3d_shader_compiler
+{
+    struct d3d12_device *device;
+
+    struct vkd3d_mutex mutex;
+    struct vkd3d_cond cond;
+    struct vkd3d_cond done_cond;
+    struct list batches;
+    bool should_exit;
+
+    union vkd3d_thread_handle threads[VKD3D_MAX_SHADER_COMPILE_THREADS];
+    unsigned int thread_count;
+    unsigned int max_thread_count;
+};
+
+HRESULT vkd3d_shader_compiler_init(struct vkd3d_shader_compiler *compiler, struct d3d12_device *device);
+void vkd3d_shader_compiler_cleanup(struct vkd3d_shader_compiler *compiler);
+void vkd3d_shader_compiler_run(struct vkd3d_shader_compiler *compiler,
+        struct vkd3d_shader_compile_task *tasks, unsigned int count);
+
 struct vkd3d_private_store
 {
     struct vkd3d_mutex mutex;
@@ -1470,6 +1530,8 @@ struct d3d12_device
     struct vkd3d_mutex mutex;
     struct vkd3d_mutex desc_mutex[8];
     struct vkd3d_render_pass_cache render_pass_cache;
+    struct vkd3d_shader_cache shader_cache;
+    struct vkd3d_shader_compiler shader_compiler;
     VkPipelineCache vk_pipeline_cache;
 
     VkPhysicalDeviceMemoryProperties memory_properties;
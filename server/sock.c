@@ -1407,6 +1407,21 @@ static void sock_queue_async( struct fd *fd, struct async *async, int type, int
     set_error( STATUS_PENDING );
 }
 
+/* Every datagram satisfies exactly one request, in the order the requests
+ * were queued, so only one async may be alerted at a time. Rather than
+ * waiting for the socket to be polled again, wake the next one as soon as
+ * the previous one has consumed its datagram. */
+static void sock_wake_next_dgram_async( struct sock *sock, struct async_queue *queue )
+{
+    int event = (queue == &sock->read_q) ? POLLIN : POLLOUT;
+
+    if (async_waiting( queue ) && (check_fd_events( sock->fd, event ) & event))
+    {
+        if (debug_level) fprintf( stderr, "activating next async for socket %p\n", sock );
+        async_wake_up( queue, STATUS_ALERTED );
+    }
+}
+
 static void sock_reselect_async( struct fd *fd, struct async_queue *queue )
 {
     struct sock *sock = get_fd_user( fd );
@@ -1421,7 +1436,11 @@ static void sock_reselect_async( struct fd *fd, struct async_queue *queue )
      * Don't reselect an uninitialized socket; we can't call set_fd_events() on
      * a pseudo-fd. */
     if (queue != &sock->ifchange_q && sock->type)
+    {
+        if (sock->type == WS_SOCK_DGRAM && (queue == &sock->read_q || queue == &sock->write_q))
+            sock_wake_next_dgram_async( sock, queue );
         sock_reselect( sock );
+    }
 }
 
 static struct fd *sock_get_fd( struct object *obj )